@@ -0,0 +1,31 @@
+#ifndef _ALLAN_VARIANCE_H__
+#define _ALLAN_VARIANCE_H__
+
+#include <Eigen/Core>
+#include <vector>
+
+#include "imuLog.h"
+#include "imuStatistics.h"
+
+/**
+ * @brief Overlapping Allan deviation of the six IMU channels.
+ */
+struct AllanDeviation {
+    Eigen::VectorXd tau;                                            // averaging times in s
+    Eigen::Matrix<double, Eigen::Dynamic, IMU_CHANNELS> adev;       // one row per tau
+};
+
+/** Log spaced cluster sizes in [1, (n-1)/2], pointsPerDecade per factor of ten, none if pointsPerDecade < 1. */
+std::vector<Eigen::Index> allanClusterSizes(Eigen::Index n, int pointsPerDecade = 10);
+
+/**
+ * @brief Computes the overlapping Allan deviation for the given cluster sizes.
+ *
+ * tau0 is the sample interval, 0 estimates it from the time stamps. Each channel is
+ * integrated once into a prefix sum, so every cluster size costs O(n) independent of
+ * its length. Channels and cluster sizes are distributed over threads (0 = all cores).
+ */
+void allanDeviation(const ImuData &data, const std::vector<Eigen::Index> &clusterSizes, AllanDeviation &result,
+    double tau0 = 0.0, unsigned int threads = 0);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef _BAROMETER_H__
+#define _BAROMETER_H__
+
+#include <Eigen/Core>
+#include <vector>
+
+/** Standard atmosphere pressure at sea level in Pa. */
+const double SEA_LEVEL_PRESSURE = 101325.0;
+
+/** Barometric altitude in m: 145366.45 ft * 0.3048 (= 44307.69 m) * (1 - (pressure / seaLevel)^0.190284), pressures in Pa. */
+double pressureAltitude(double pressure, double seaLevel = SEA_LEVEL_PRESSURE);
+/** Batch version, evaluated as exp(0.190284 * log(x)) so Eigen can use its SIMD exp and log. */
+Eigen::ArrayXd pressureAltitude(const Eigen::ArrayXd &pressure, double seaLevel = SEA_LEVEL_PRESSURE);
+
+/**
+ * @brief Precomputed altitude table with linear interpolation.
+ *
+ * Covers the BMP280 range of 300 to 1100 hPa by default. With 50 Pa steps the
+ * interpolation error stays within a few mm; pressures outside the table are
+ * computed exactly.
+ */
+class AltitudeTable
+{
+public:
+    explicit AltitudeTable(double seaLevel = SEA_LEVEL_PRESSURE, double minPressure = 30000.0,
+        double maxPressure = 110000.0, double step = 50.0);
+
+    double operator()(double pressure) const;
+    Eigen::ArrayXd operator()(const Eigen::ArrayXd &pressure) const;
+
+    double seaLevel() const { return seaLevel_; }
+
+private:
+    double seaLevel_;
+    double min_;
+    double max_;
+    double invStep_;
+    std::vector<float> altitude_;
+};
+
+/**
+ * @brief Streaming first order low pass for altitudes.
+ *
+ * The smoothing factor follows from the time constant and the sample stamps, so
+ * irregular sample rates are handled. The first sample initializes the output.
+ */
+class AltitudeFilter
+{
+public:
+    /** timeConstant in s, 0 passes the input through. */
+    explicit AltitudeFilter(double timeConstant = 0.5);
+
+    double update(double stamp, double altitude);
+    void reset();
+
+    bool initialized() const { return initialized_; }
+    double altitude() const { return altitude_; }
+
+private:
+    double tau_;
+    bool initialized_;
+    double stamp_;
+    double altitude_;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef _CAPTURE_PIPELINE_H__
+#define _CAPTURE_PIPELINE_H__
+
+#include <opencv2/videoio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+
+#include "framePool.h"
+#include "settings.h"
+#include "spscQueue.h"
+
+/**
+ * @brief Frame queue of one consumer of a CapturePipeline.
+ *
+ * If the consumer falls behind, new frames are skipped for it and counted, the
+ * camera and the other consumers are not held up.
+ */
+class FrameConsumer
+{
+public:
+    explicit FrameConsumer(std::size_t capacity) : queue_(capacity) {}
+
+    /** Next frame, waits up to timeoutMs and returns an empty reference if there is none. */
+    FrameRef next(int timeoutMs = 100);
+
+    uint64_t received() const { return queue_.pushed(); }
+    uint64_t dropped() const { return queue_.overflows(); }
+
+private:
+    friend class CapturePipeline;
+
+    SpscQueue<FrameRef> queue_;
+};
+
+/**
+ * @brief Grabs camera frames on a background thread into a FramePool.
+ *
+ * Every frame is passed by reference to all consumers, e.g. display, encoding and
+ * recording on their own threads, so a slow consumer never stalls the capture.
+ * When all pooled frames are still referenced the camera keeps being read but
+ * the frame is discarded and counted.
+ */
+class CapturePipeline
+{
+public:
+    explicit CapturePipeline(std::size_t poolSize = 8);
+    ~CapturePipeline();
+
+    /** Opens the camera of the settings, the pool is sized by its first frame. */
+    bool open(const Settings &settings);
+    /** Adds a consumer, only before start(). */
+    FrameConsumer &addConsumer(std::size_t capacity = 2);
+
+    void start();
+    void stop();
+
+    /** False once the camera stopped delivering frames. */
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    uint64_t captured() const { return captured_.load(std::memory_order_relaxed); }
+    /** Frames discarded because every pooled frame was still in use. */
+    uint64_t exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+private:
+    CapturePipeline(const CapturePipeline &);
+    CapturePipeline &operator=(const CapturePipeline &);
+
+    void grab();
+
+    std::size_t poolSize_;
+    cv::VideoCapture capture_;
+    std::unique_ptr<FramePool> pool_;
+    std::deque<FrameConsumer> consumers_;     // deque, so references stay valid
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> stopping_;
+    int width_;
+    int height_;
+    std::atomic<uint64_t> captured_;
+    std::atomic<uint64_t> exhausted_;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef _COMMAND_CHANNEL_H__
+#define _COMMAND_CHANNEL_H__
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Changes the message subscriptions of a SensorCube at runtime.
+ *
+ * subscribe() and unsubscribe() only edit the wanted set, flush() sends it as a
+ * single {"messages":[...]} command, so any number of changes costs one write.
+ * The cube does not answer commands, so a command counts as acknowledged once
+ * every subscribed type has arrived after it and no unsubscribed type has
+ * arrived for the settle time. Otherwise it is resent after the timeout and
+ * marked as failed after the given number of retries.
+ */
+class CommandChannel
+{
+public:
+    /** Sends one complete command line to the cube. */
+    typedef std::function<void(const std::string &command)> Writer;
+
+    explicit CommandChannel(Writer writer, double timeout = 2.0, int retries = 3, double settle = 0.2);
+
+    void subscribe(const std::string &type);
+    void unsubscribe(const std::string &type);
+    void setSubscriptions(const std::vector<std::string> &types);
+    const std::vector<std::string> &subscriptions() const { return wanted_; }
+
+    /** Sends the subscriptions if they differ from the last command. */
+    void flush();
+    /** Reports the "msg" of a received line, cheap while no command is pending. */
+    void received(const char *type);
+    /** Checks for acknowledgement and resends on timeout, call regularly. */
+    void tick();
+
+    bool pending() const { return pending_; }
+    bool failed() const { return failed_; }
+    uint64_t commands() const { return commands_; }
+    uint64_t resent() const { return resent_; }
+
+private:
+    void send();
+    static bool contains(const std::vector<std::string> &set, const char *type);
+
+    Writer writer_;
+    std::chrono::steady_clock::duration timeout_;
+    std::chrono::steady_clock::duration settle_;
+    int retries_;
+
+    std::vector<std::string> wanted_;       // sorted
+    std::vector<std::string> sent_;         // subscriptions of the last command
+    std::vector<std::string> waiting_;      // subscribed types not seen since the last command
+    bool pending_;
+    bool failed_;
+    int attempts_;
+    std::chrono::steady_clock::time_point sentAt_;
+    std::chrono::steady_clock::time_point lastUnwanted_;
+    uint64_t commands_;
+    uint64_t resent_;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _DISPARITY_ENGINE_H__
+#define _DISPARITY_ENGINE_H__
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core.hpp>
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Disparity and depth of rectified side-by-side stereo frames.
+ *
+ * Matching uses cv::StereoSGBM in 3-way mode, split into row bands that overlap by
+ * the block size and run in parallel, one matcher per band. Disparities are
+ * CV_16S in 1/16 pixel of the left image, invalid ones are negative.
+ */
+class DisparityEngine
+{
+public:
+    /** numDisparities is rounded up to a multiple of 16, blockSize to an odd number. */
+    explicit DisparityEngine(int numDisparities = 64, int blockSize = 5, int bands = 4);
+
+    /** Rectified projection matrices as given by StereoRectifier, needed for reproject(). */
+    void setProjection(const cv::Mat &P1, const cv::Mat &P2);
+
+    /** Disparity of the left half of a rectified side-by-side image (gray or BGR). */
+    void compute(const cv::Mat &rectified, cv::Mat &disparity);
+
+    /**
+     * Camera coordinates (x right, y down, z forward) of all valid disparities up
+     * to maxDepth, in the unit of the calibration baseline, i.e. m for
+     * 9/calibration.yaml. Replaces points.
+     */
+    void reproject(const cv::Mat &disparity, std::vector<cv::Point3f> &points,
+        float maxDepth = std::numeric_limits<float>::infinity()) const;
+
+    int numDisparities() const { return numDisparities_; }
+
+private:
+    struct Band {
+        cv::Ptr<cv::StereoSGBM> matcher;
+        cv::Mat disparity;
+    };
+
+    int numDisparities_;
+    int blockSize_;
+    std::vector<Band> bands_;
+    mutable std::vector<std::vector<cv::Point3f> > bandPoints_;
+    cv::Mat left_, right_;
+    // reprojection, see cv::stereoRectify: X = (x - cx) b / (d - dcx), Z = f b / (d - dcx)
+    double f_, cx_, cy_, baseline_, dcx_;
+};
+
+/**
+ * Writes points as "x y z" lines, the format read by 6/kdtree/kdtest and 7/normals-cpp.
+ * False if the file could not be written.
+ */
+bool writePointCloud(const std::string &path, const std::vector<cv::Point3f> &points);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef _FRAME_POOL_H__
+#define _FRAME_POOL_H__
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Camera image with its capture metadata.
+ */
+struct Frame {
+    cv::Mat image;
+    uint64_t seq;
+    double stamp;   // host system clock in s at capture, from the V4L2 buffer where available
+};
+
+/** Shared, read-only reference to a pooled frame. */
+typedef std::shared_ptr<const Frame> FrameRef;
+
+/**
+ * @brief Fixed set of preallocated frames that are handed out by reference count.
+ *
+ * acquire() returns a free frame, it goes back to the pool when its last reference
+ * is released, on whatever thread that happens. The image buffers are allocated
+ * once, so capture never allocates as long as the camera keeps its format.
+ */
+class FramePool
+{
+public:
+    FramePool(std::size_t count, int rows, int cols, int type);
+
+    /** Free frame, nullptr if all frames are in use. */
+    std::shared_ptr<Frame> acquire();
+
+    std::size_t size() const { return state_->frames.size(); }
+    std::size_t available() const;
+
+private:
+    struct State {
+        std::vector<Frame> frames;
+        std::vector<Frame*> free;
+        std::mutex mutex;
+    };
+
+    // shared with the references, so frames may outlive the pool
+    std::shared_ptr<State> state_;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef _FRAME_RECORDER_H__
+#define _FRAME_RECORDER_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "framePool.h"
+
+/**
+ * @file
+ * @brief Background recording of camera frames.
+ *
+ * Raw container layout (little endian):
+ *   FrameFileHeader
+ *   per frame: FrameRecordHeader, bytes of pixel data (rows of cols * elemSize, no padding)
+ */
+
+const char FRAME_FILE_MAGIC[8] = {'S', 'C', 'F', 'R', 'A', 'M', 'E', 'S'};
+const uint32_t FRAME_FILE_VERSION = 1;
+
+struct FrameFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct FrameRecordHeader {
+    uint64_t seq;
+    double stamp;
+    int32_t rows;
+    int32_t cols;
+    int32_t type;           // OpenCV type, e.g. CV_8UC3
+    uint32_t reserved;
+    uint64_t bytes;
+};
+
+enum class FrameFormat {
+    Png,
+    Jpeg,
+    Raw     // one container file, no encoding
+};
+
+/**
+ * @brief Encodes and writes frames on a pool of worker threads.
+ *
+ * write() only queues a reference to the frame and never blocks the capture thread.
+ * If the queue is full the frame is dropped and counted. Images are written as
+ * frame_<seq>.png / .jpg, raw frames are appended to frames.raw by a single worker
+ * since that is bound by the disk, not the CPU.
+ */
+class FrameRecorder
+{
+public:
+    /** workers = 0 uses one per hardware thread. */
+    FrameRecorder(FrameFormat format, unsigned int workers = 0, std::size_t queueSize = 32);
+    ~FrameRecorder();
+
+    /** directory must exist. */
+    bool open(const std::string &directory);
+    /** Writes out the queued frames and stops the workers. */
+    void close();
+
+    /** Queues a frame, false if the queue is full and it was dropped. */
+    bool write(const FrameRef &frame);
+
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t failed() const { return failed_.load(std::memory_order_relaxed); }
+    std::size_t backlog();
+    /** Most frames referenced at once, the queue plus one in each worker. */
+    std::size_t capacity() const { return queueSize_ + workerCount_; }
+
+private:
+    FrameRecorder(const FrameRecorder &);
+    FrameRecorder &operator=(const FrameRecorder &);
+
+    void work();
+    bool store(const Frame &frame, std::vector<unsigned char> &buffer);
+
+    FrameFormat format_;
+    unsigned int workerCount_;
+    std::size_t queueSize_;
+    std::string directory_;
+    std::FILE *raw_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<FrameRef> queue_;
+    bool closing_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<uint64_t> written_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> failed_;
+};
+
+/** Parses "png", "jpg" / "jpeg" or "raw", false for anything else. */
+bool parseFrameFormat(const std::string &name, FrameFormat &format);
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef _FRAME_SYNC_H__
+#define _FRAME_SYNC_H__
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "framePool.h"
+#include "messageDecoder.h"
+
+/**
+ * @brief Maps host system clock times onto the SensorCube stamp clock.
+ *
+ * The offset is the smallest difference between host arrival time and device
+ * stamp over the last one to two windows, i.e. that of the fastest transfers,
+ * so it follows drift without picking up queuing delays. Written by one thread,
+ * readable from any.
+ */
+class ClockAlignment
+{
+public:
+    explicit ClockAlignment(double window = 10.0);
+
+    /** A message with device stamp arrived at host system time received. */
+    void update(double stamp, double received);
+
+    bool valid() const { return valid_.load(std::memory_order_acquire); }
+    /** Host minus device time in s. */
+    double offset() const { return offset_.load(std::memory_order_relaxed); }
+    double toDevice(double hostTime) const { return hostTime - offset(); }
+
+private:
+    double window_;
+    double windowStart_;
+    double current_;    // smallest offset in the current window
+    double previous_;   // smallest offset in the previous window
+    std::atomic<double> offset_;
+    std::atomic<bool> valid_;
+};
+
+/**
+ * @brief Ring of the latest IMU samples, shared by the serial thread and the frame thread.
+ *
+ * The writer overwrites the oldest samples. All access is guarded by a mutex, at IMU
+ * rates it is hardly ever contended and readers only hold it while copying.
+ * Stamps must increase.
+ */
+class ImuRing
+{
+public:
+    /** capacity is rounded up to a power of two. */
+    explicit ImuRing(std::size_t capacity);
+
+    void push(const ImuSample &sample);
+
+    /** Last sample at or before stamp and the first after it, false if stamp is not covered. */
+    bool bracket(double stamp, ImuSample &before, ImuSample &after) const;
+    /** Appends the samples with from < stamp, up to and including the first after to. */
+    bool range(double from, double to, std::vector<ImuSample> &out) const;
+
+    /** Stamp of the newest sample, NaN if there is none. */
+    double newest() const;
+
+private:
+    // index of the first sample with a stamp after t in [begin, end), mutex held
+    std::size_t upperBound(std::size_t begin, std::size_t end, double t) const;
+    std::size_t oldest() const { return head_ > slots_.size() ? head_ - slots_.size() : 0; }
+
+    mutable std::mutex mutex_;
+    std::vector<ImuSample> slots_;
+    std::size_t mask_;
+    std::size_t head_;
+};
+
+/**
+ * @brief Camera frame with the IMU data around it on the SensorCube clock.
+ */
+struct FrameImuPair {
+    FrameRef frame;
+    double stamp;                       // frame time on the SensorCube clock
+    ImuSample imu;                      // IMU interpolated to the frame time
+    std::vector<ImuSample> samples;     // samples since the previous frame, up to the first after this one
+};
+
+/**
+ * @brief Pairs camera frames with the IMU stream of a SensorCube.
+ *
+ * The serial thread adds IMU samples with their host arrival time, which also
+ * keeps the clock alignment up to date; the frame thread pairs frames once IMU
+ * data after the frame time has arrived.
+ */
+class FrameImuSync
+{
+public:
+    enum Result {
+        Paired,
+        Pending,    // no IMU data after the frame yet, try again later
+        Failed      // frame older than the buffered IMU data or the IMU has a gap there
+    };
+
+    explicit FrameImuSync(std::size_t imuCapacity = 4096, double maxGap = 0.05);
+
+    /** IMU thread */
+    void addImu(const ImuSample &sample, double received);
+
+    /** Frame thread, out is reused to avoid allocations. */
+    Result pair(const FrameRef &frame, FrameImuPair &out);
+
+    const ClockAlignment &clock() const { return clock_; }
+
+private:
+    ClockAlignment clock_;
+    ImuRing imu_;
+    double maxGap_;
+    double lastFrame_;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef _HEIGHT_GRID_H__
+#define _HEIGHT_GRID_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 2.5D height map that grids a stream of points into running per-cell statistics.
+ *
+ * Each cell keeps count, first, min and max height and the sum and sum of squares
+ * of the heights relative to its first one, which keeps the variance accurate for
+ * heights far from zero. The statistics are stored in flat arrays per field, so
+ * memory depends on the number of cells only, not on the number of points.
+ * Points are assigned to the nearest cell center, cell (0, 0) is centered on
+ * (minX, minY).
+ */
+class HeightGrid
+{
+public:
+    /** A cell size <= 0 or bounds with max < min give an empty grid that rejects every point. */
+    HeightGrid(double minX, double minY, double maxX, double maxY, double cellSize);
+
+    /** Adds a point, false if it lies outside the grid. */
+    bool add(double x, double y, float z);
+
+    bool empty() const { return sizeX_ == 0; }
+    int sizeX() const { return sizeX_; }
+    int sizeY() const { return sizeY_; }
+    double cellSize() const { return cellSize_; }
+
+    uint32_t count(int ix, int iy) const { return count_[index(ix, iy)]; }
+    float first(int ix, int iy) const { return first_[index(ix, iy)]; }
+    float min(int ix, int iy) const { return min_[index(ix, iy)]; }
+    float max(int ix, int iy) const { return max_[index(ix, iy)]; }
+    double mean(int ix, int iy) const;
+    /** Sample standard deviation, 0 for cells with less than two points. */
+    double stddev(int ix, int iy) const;
+
+    /** Points added so far and points rejected by add(). */
+    uint64_t points() const { return points_; }
+    uint64_t outside() const { return outside_; }
+
+private:
+    std::size_t index(int ix, int iy) const { return std::size_t(ix) * sizeY_ + iy; }
+
+    double minX_;
+    double minY_;
+    double cellSize_;
+    double invCellSize_;
+    int sizeX_;
+    int sizeY_;
+    uint64_t points_;
+    uint64_t outside_;
+    std::vector<uint32_t> count_;
+    std::vector<float> first_;
+    std::vector<float> min_;
+    std::vector<float> max_;
+    std::vector<double> sum_;       // of z - first
+    std::vector<double> sumSq_;     // of (z - first)^2
+};
+
+#endif
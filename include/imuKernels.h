@@ -0,0 +1,43 @@
+#ifndef _IMU_KERNELS_H__
+#define _IMU_KERNELS_H__
+
+#include <Eigen/Core>
+
+#include "imuLog.h"
+#include "imuStatistics.h"
+
+/**
+ * @file
+ * @brief Batch kernels over the channel arrays of ImuData.
+ *
+ * Everything is written as whole-array Eigen expressions so the compiler can use
+ * SIMD; the recursive filters run over all six channels at once instead.
+ */
+
+/** sqrt(ax^2 + ay^2 + az^2) */
+Eigen::ArrayXd accelerationNorm(const ImuData &data);
+/** sqrt(wx^2 + wy^2 + wz^2) */
+Eigen::ArrayXd gyroNorm(const ImuData &data);
+
+/** Mean of every channel over the first duration seconds, e.g. while the IMU is at rest. */
+ImuVector estimateBias(const ImuData &data, double duration);
+void removeBias(ImuData &data, const ImuVector &bias);
+
+/** Rectangular integration of the angular rates, angle[0] = 0. */
+void integrateGyro(const ImuData &data, Eigen::ArrayXd &angleX, Eigen::ArrayXd &angleY, Eigen::ArrayXd &angleZ);
+
+/** Trailing mean over window samples, the first samples average what is available. */
+Eigen::ArrayXd movingAverage(const Eigen::ArrayXd &x, Eigen::Index window);
+void movingAverage(ImuData &data, Eigen::Index window);
+
+/** First order low pass y += alpha * (x - y) on all channels. */
+void lowPass(ImuData &data, double alpha);
+
+/**
+ * Linear interpolation of all channels onto a uniform grid of rate Hz, starting at
+ * the first stamp. A single sample gives a single sample. False and out empty if
+ * rate is not positive and finite, or the last stamp is before the first or not finite.
+ */
+bool resample(const ImuData &data, double rate, ImuData &out);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef _IMU_LOG_H__
+#define _IMU_LOG_H__
+
+#include <Eigen/Core>
+#include <functional>
+#include <string>
+
+#include "messageDecoder.h"
+
+/**
+ * @brief imu_raw samples of a log, one array per channel.
+ */
+struct ImuData {
+    Eigen::ArrayXd t;
+    Eigen::ArrayXd ax, ay, az;
+    Eigen::ArrayXd wx, wy, wz;
+
+    Eigen::Index size() const { return t.size(); }
+};
+
+/**
+ * @brief Loads all imu_raw messages of a JSON-lines log or a binary recording.
+ *
+ * A JSON-lines file is memory mapped and split into newline aligned chunks which are decoded
+ * in parallel directly into the preallocated channel arrays. threads = 0 uses all
+ * cores. Returns false if the file cannot be opened, throws on malformed lines.
+ */
+bool loadIMU(const std::string &path, ImuData &data, unsigned int threads = 0);
+
+/**
+ * @brief Passes every imu_raw sample of a JSON-lines log or a binary recording to callback.
+ *
+ * The file is mapped and read sequentially, memory use does not grow with its size.
+ * Returns false if the file cannot be opened, throws on malformed lines.
+ */
+bool streamIMU(const std::string &path, const std::function<void(const ImuSample &)> &callback);
+
+#endif
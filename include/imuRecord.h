@@ -0,0 +1,167 @@
+#ifndef _IMU_RECORD_H__
+#define _IMU_RECORD_H__
+
+#include <Eigen/Core>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "imuLog.h"
+#include "mappedFile.h"
+#include "messageDecoder.h"
+
+/**
+ * @file
+ * @brief Binary columnar recording of imu_raw samples.
+ *
+ * Layout (little endian):
+ *   RecordHeader
+ *   blocks: RecordBlockHeader, t[count] (f64), seq[count] (u64),
+ *           ax, ay, az, wx, wy, wz [count] each (f32 or f64, see RecordBlockHeader::flags)
+ *   index:  RecordIndexEntry[blockCount]
+ *   RecordFooter
+ *
+ * Every array starts 8 byte aligned. The accelerometer and the gyroscope channels of
+ * a block are each stored as f32 when all of their values are exactly representable,
+ * so recording is lossless.
+ * The index stores the time and sequence range of every block, so a time window
+ * can be located without touching the samples. Files without a footer (recorder
+ * killed) are recovered by scanning the blocks, the scan stops at the first block
+ * without the block magic or with implausible counts or stamps.
+ */
+
+const char RECORD_MAGIC[8] = {'S', 'C', 'I', 'M', 'U', 'R', 'E', 'C'};
+const uint32_t RECORD_VERSION = 3;
+const uint32_t RECORD_BLOCK_MAGIC = 0x4b424353;    // "SCBK"
+const int RECORD_CHANNELS = 6;
+const uint32_t RECORD_FLOAT_ACC = 1;
+const uint32_t RECORD_FLOAT_GYRO = 2;
+
+struct RecordHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockCapacity;
+};
+
+struct RecordBlockHeader {
+    uint32_t magic;         // RECORD_BLOCK_MAGIC
+    uint32_t count;
+    uint32_t flags;         // RECORD_FLOAT_ACC | RECORD_FLOAT_GYRO
+    uint32_t reserved;
+};
+
+inline uint32_t recordFloatFlag(int channel)
+{
+    return channel < 3 ? RECORD_FLOAT_ACC : RECORD_FLOAT_GYRO;
+}
+
+struct RecordIndexEntry {
+    uint64_t offset;        // of the RecordBlockHeader
+    uint64_t count;
+    double tMin, tMax;
+    uint64_t seqMin, seqMax;
+};
+
+struct RecordFooter {
+    uint64_t indexOffset;
+    uint64_t blockCount;
+    char magic[8];
+};
+
+/**
+ * @brief Appends imu_raw samples to a recording, one block every blockCapacity samples.
+ */
+class ImuRecordWriter
+{
+public:
+    explicit ImuRecordWriter(uint32_t blockCapacity = 4096);
+    ~ImuRecordWriter();
+
+    bool open(const std::string &path);
+    void write(const ImuSample &sample);
+    /** Writes the pending block, the index and the footer. */
+    void close();
+
+    bool isOpen() const { return file_ != nullptr; }
+
+private:
+    ImuRecordWriter(const ImuRecordWriter &);
+    ImuRecordWriter &operator=(const ImuRecordWriter &);
+
+    void flushBlock();
+
+    std::FILE *file_;
+    uint64_t offset_;
+    uint32_t capacity_;
+    uint32_t count_;
+    std::vector<double> t_;
+    std::vector<uint64_t> seq_;
+    std::vector<double> channels_[RECORD_CHANNELS];
+    std::vector<float> floats_;
+    std::vector<RecordIndexEntry> index_;
+};
+
+/**
+ * @brief One block of a mapped recording. Points into the mapping, nothing is copied.
+ */
+struct ImuRecordBlock {
+    Eigen::Index count;
+    const double *t;
+    const uint64_t *seq;
+    const void *channels[RECORD_CHANNELS];   // ax, ay, az, wx, wy, wz
+    uint32_t flags;
+    double tMin, tMax;
+    uint64_t seqMin, seqMax;
+
+    bool isFloat(int channel) const { return (flags & recordFloatFlag(channel)) != 0; }
+    Eigen::Map<const Eigen::ArrayXd> stamps() const { return Eigen::Map<const Eigen::ArrayXd>(t, count); }
+    /** Channel as stored, Scalar must be float if isFloat(c) and double otherwise. */
+    template<typename Scalar>
+    Eigen::Map<const Eigen::Array<Scalar, Eigen::Dynamic, 1> > channel(int c) const
+    {
+        return Eigen::Map<const Eigen::Array<Scalar, Eigen::Dynamic, 1> >(static_cast<const Scalar*>(channels[c]), count);
+    }
+    /** Copies a channel into out, which must have at least count entries. */
+    void read(int channel, double *out) const;
+};
+
+/**
+ * @brief Memory mapped reader for recordings written by ImuRecordWriter.
+ */
+class ImuRecordReader
+{
+public:
+    ImuRecordReader() : capacity_(0), size_(0), ordered_(true) {}
+
+    bool open(const std::string &path);
+
+    std::size_t blockCount() const { return blocks_.size(); }
+    const ImuRecordBlock &block(std::size_t i) const { return blocks_[i]; }
+    Eigen::Index size() const { return size_; }
+    /** False if the block stamp ranges are not ascending, searches are linear then. */
+    bool ordered() const { return ordered_; }
+
+    /** Copies all samples into data. */
+    void read(ImuData &data) const;
+
+    /** Index of the first block that may contain samples at or after stamp, blockCount() if none. */
+    std::size_t findBlock(double stamp) const;
+    /** Copies the samples with t0 <= t <= t1 into data, only the overlapping blocks are read. */
+    Eigen::Index readWindow(double t0, double t1, ImuData &data) const;
+
+    /** True if the file starts with the recording magic. */
+    static bool isRecording(const std::string &path);
+
+private:
+    bool parseBlock(uint64_t offset, ImuRecordBlock &block, uint64_t &next) const;
+    static bool overlaps(const ImuRecordBlock &b, double t0, double t1) { return b.tMax >= t0 && b.tMin <= t1; }
+
+    MappedFile file_;
+    uint32_t capacity_;
+    std::vector<ImuRecordBlock> blocks_;
+    Eigen::Index size_;
+    bool ordered_;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _IMU_STATISTICS_H__
+#define _IMU_STATISTICS_H__
+
+#include <Eigen/Core>
+#include <cstdint>
+
+#include "messageDecoder.h"
+
+enum ImuChannel {
+    IMU_AX, IMU_AY, IMU_AZ, IMU_WX, IMU_WY, IMU_WZ, IMU_CHANNELS
+};
+
+typedef Eigen::Matrix<double, IMU_CHANNELS, 1> ImuVector;
+typedef Eigen::Matrix<double, IMU_CHANNELS, IMU_CHANNELS> ImuMatrix;
+
+inline ImuVector imuVector(const ImuSample &s)
+{
+    ImuVector v;
+    v << s.ax, s.ay, s.az, s.wx, s.wy, s.wz;
+    return v;
+}
+
+/**
+ * @brief Running mean, variance, covariance and extrema of the six IMU channels.
+ *
+ * Samples are added one at a time with Welford's update, so the memory use does not
+ * depend on the number of samples. Two instances can be merged, e.g. after
+ * processing chunks of a log in parallel.
+ */
+class ImuStatistics
+{
+public:
+    ImuStatistics();
+
+    void add(const ImuSample &sample);
+    void add(const ImuVector &x);
+    void merge(const ImuStatistics &other);
+    void reset();
+
+    uint64_t count() const { return n_; }
+    const ImuVector &mean() const { return mean_; }
+    const ImuVector &min() const { return min_; }
+    const ImuVector &max() const { return max_; }
+    double mean(int channel) const { return mean_[channel]; }
+    /** Sample variance (n-1), NaN for fewer than two samples. */
+    ImuVector variance() const;
+    double variance(int channel) const;
+    double stdDev(int channel) const;
+    /** Sample covariance (n-1) of all channels. */
+    ImuMatrix covariance() const;
+
+private:
+    uint64_t n_;
+    ImuVector mean_;
+    ImuVector min_;
+    ImuVector max_;
+    ImuMatrix comoment_;    // sum of (x - mean)(x - mean)^T
+};
+
+#endif
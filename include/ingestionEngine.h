@@ -0,0 +1,91 @@
+#ifndef _INGESTION_ENGINE_H__
+#define _INGESTION_ENGINE_H__
+
+#include <asio/io_context.hpp>
+#include <asio/serial_port.hpp>
+#include <asio/strand.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "messageDecoder.h"
+#include "serialReader.h"
+
+/**
+ * @brief Reads lines from several SensorCube serial ports on a single io_context.
+ *
+ * Every port is read asynchronously into its own LineBuffer. Complete lines are
+ * passed to one shared handler together with the index of the port they came from,
+ * either raw or decoded on the port's strand, so with more than one worker thread
+ * the ports are decoded in parallel. The reads of a port are serialized by its
+ * strand and the handler calls are serialized by the engine, so the handler never
+ * runs concurrently with itself.
+ */
+class IngestionEngine
+{
+public:
+    typedef std::function<void(std::size_t port, const LineView &line)> Handler;
+    /** msg is nullptr for lines that could not be decoded. */
+    typedef std::function<void(std::size_t port, const LineView &line, const Message *msg)> MessageHandler;
+
+    /** Dispatches the raw lines. */
+    explicit IngestionEngine(Handler handler, std::size_t bufferSize = 4096);
+    /** Dispatches every line with its decoded message. */
+    explicit IngestionEngine(MessageHandler handler, std::size_t bufferSize = 4096);
+
+    /** Opens and configures a port, returns its index. */
+    std::size_t addPort(const std::string &device, int baudrate);
+
+    /**
+     * Runs the engine on the calling thread and threads-1 additional workers until
+     * stop() or until reading failed on every port, e.g. because the devices were
+     * unplugged.
+     */
+    void run(unsigned int threads = 1);
+    void stop();
+
+    /** Queues data to be written to a port on its strand, safe to call from any thread. */
+    void write(std::size_t index, const std::string &data);
+
+    asio::io_context &context() { return ctx_; }
+    asio::serial_port &port(std::size_t index) { return ports_[index]->port; }
+    std::size_t portCount() const { return ports_.size(); }
+    /** Ports that are still read, those whose reads failed are given up. */
+    std::size_t openPorts() const { return openPorts_.load(std::memory_order_relaxed); }
+    std::size_t droppedBytes(std::size_t index) const { return ports_[index]->buffer.droppedBytes(); }
+    /** Lines a MessageHandler engine could not decode. */
+    uint64_t undecodable() const { return undecodable_.load(std::memory_order_relaxed); }
+
+private:
+    struct Port {
+        Port(asio::io_context &ctx, std::size_t bufferSize);
+
+        asio::serial_port port;
+        asio::strand<asio::io_context::executor_type> strand;
+        LineBuffer buffer;
+        bool synced;
+        std::string device;
+        std::deque<std::string> writes;     // only accessed on the strand
+        Message msg;                        // only accessed on the strand
+    };
+
+    void startRead(std::size_t index);
+    void handleRead(std::size_t index, const asio::error_code &ec, std::size_t size);
+    void startWrite(std::size_t index);
+
+    asio::io_context ctx_;
+    Handler handler_;
+    MessageHandler messageHandler_;
+    std::mutex dispatchMutex_;
+    std::atomic<uint64_t> undecodable_;
+    std::atomic<std::size_t> openPorts_;
+    std::size_t bufferSize_;
+    std::vector<std::unique_ptr<Port>> ports_;
+};
+
+#endif
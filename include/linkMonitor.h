@@ -0,0 +1,80 @@
+#ifndef _LINK_MONITOR_H__
+#define _LINK_MONITOR_H__
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "messageDecoder.h"
+
+/**
+ * @brief Log-linear histogram of durations in microseconds, in the style of HdrHistogram.
+ *
+ * Values below 128 us are counted exactly, larger ones in buckets of 64 steps per
+ * power of two, i.e. with less than 1.6 % relative error. Memory is fixed; values
+ * beyond 2^40 us are counted in the last bucket.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(uint64_t us);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ > 0 ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ > 0 ? double(sum_) / double(count_) : 0.0; }
+    /** Value below which fraction q of the recorded values lie, q in [0, 1]. */
+    uint64_t percentile(double q) const;
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_;
+    uint64_t min_;
+    uint64_t max_;
+    uint64_t sum_;
+};
+
+/**
+ * @brief Link health from the heartbeat stream of one SensorCube.
+ *
+ * Tracks sequence gaps, the jitter between host and device inter-arrival times and
+ * the host-device clock offset. The offset is the smallest host minus device
+ * stamp of the previous period, i.e. it includes the fastest transfer; latency
+ * is measured relative to it, so it shows queuing and batching on the link.
+ * Counters and histograms cover the period since the last report().
+ */
+class HeartbeatMonitor
+{
+public:
+    HeartbeatMonitor();
+
+    /** received is the host time of arrival in s, on the same epoch as the device stamps. */
+    void update(const Heartbeat &heartbeat, double received);
+    /** Writes the period as one JSON line and starts the next period. */
+    void report(std::ostream &out, double now);
+
+    uint64_t missing() const { return missing_; }
+    const LatencyHistogram &jitter() const { return jitter_; }
+    const LatencyHistogram &latency() const { return latency_; }
+
+private:
+    bool started_;
+    unsigned long lastSeq_;
+    double lastStamp_;
+    double lastReceived_;
+    double offset_;         // clock offset used for the latencies, from the previous period
+    double periodOffset_;   // smallest offset seen in this period
+
+    uint64_t received_;
+    uint64_t missing_;
+    uint64_t reordered_;
+    uint64_t totalReceived_;
+    uint64_t totalMissing_;
+    LatencyHistogram jitter_;
+    LatencyHistogram latency_;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _LOG_REPLAY_H__
+#define _LOG_REPLAY_H__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "imuRecord.h"
+#include "mappedFile.h"
+#include "messageDecoder.h"
+#include "serialReader.h"
+
+/**
+ * @brief Reads a recorded log back line by line as the SensorCube sent it.
+ *
+ * JSON-lines logs are returned as they are, recordings of ImuRecordWriter are
+ * formatted as imu_raw lines again. Each line comes with its stamp, NaN for
+ * lines without one.
+ */
+class LogReplay
+{
+public:
+    LogReplay();
+
+    bool open(const std::string &path);
+
+    /** Next line, valid until the next call; false at the end of the log. */
+    bool next(LineView &line, double &stamp);
+    /** Starts over at the first line. */
+    void rewind();
+
+private:
+    bool recording_;
+    MappedFile file_;
+    const char *pos_;
+    ImuRecordReader record_;
+    std::size_t block_;
+    Eigen::Index sample_;
+    Message msg_;
+    char line_[320];
+};
+
+/**
+ * @brief Paces replayed lines by their stamps.
+ *
+ * speed 1 reproduces the original timing, N plays N times faster and 0 as fast as
+ * possible. The first stamp is played immediately; when the consumer falls
+ * behind, lines are sent without waiting until it has caught up.
+ */
+class ReplayClock
+{
+public:
+    explicit ReplayClock(double speed = 1.0);
+
+    /** Sleeps until the line with this stamp is due, lines without a stamp are due at once. */
+    void wait(double stamp);
+    void reset();
+
+    /** How far the replay lags behind the requested timing, in s of host time. */
+    double lag() const { return lag_; }
+
+private:
+    double speed_;
+    bool started_;
+    double firstStamp_;
+    std::chrono::steady_clock::time_point start_;
+    double lag_;
+};
+
+#endif
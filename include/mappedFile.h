@@ -0,0 +1,36 @@
+#ifndef _MAPPED_FILE_H__
+#define _MAPPED_FILE_H__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Read-only view of a whole file.
+ *
+ * Uses mmap on Linux and macOS, on other systems the file is read into memory.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return open_; }
+    const char *data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    const char *data_;
+    std::size_t size_;
+    bool open_;
+    std::vector<char> fallback_;
+};
+
+#endif
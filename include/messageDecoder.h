@@ -0,0 +1,53 @@
+#ifndef _MESSAGE_DECODER_H__
+#define _MESSAGE_DECODER_H__
+
+#include <cstddef>
+
+enum class MessageType {
+    None,       // line without "msg" key
+    Other,      // message type without a typed decoder
+    ImuRaw,
+    Heartbeat,
+    PressureRaw
+};
+
+struct ImuSample {
+    double stamp;
+    unsigned long seq;
+    double ax, ay, az;
+    double wx, wy, wz;
+};
+
+struct Heartbeat {
+    double stamp;
+    unsigned long seq;
+};
+
+struct PressureSample {
+    double stamp;
+    unsigned long seq;
+    unsigned long pressure;
+};
+
+const std::size_t MESSAGE_NAME_CAPACITY = 32;
+
+struct Message {
+    MessageType type;
+    char name[MESSAGE_NAME_CAPACITY];   // "msg" value, also of untyped messages, empty if there is none
+    double stamp;       // "stamp" of any message type, NaN if there is none
+    ImuSample imu;
+    Heartbeat heartbeat;
+    PressureSample pressure;
+};
+
+/**
+ * @brief Decodes one SensorCube JSON line into the typed member of msg.
+ *
+ * Flat objects are decoded in a single pass without building a DOM. Lines the
+ * fast path does not understand (nested values, escaped strings, missing fields,
+ * syntax errors) are handed to nlohmann::json, which throws on invalid input.
+ * A missing "seq" decodes as 0 for imu_raw and pressure_raw. Returns msg.type.
+ */
+MessageType decodeMessage(const char *begin, const char *end, Message &msg);
+
+#endif
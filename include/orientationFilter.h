@@ -0,0 +1,39 @@
+#ifndef _ORIENTATION_FILTER_H__
+#define _ORIENTATION_FILTER_H__
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include "messageDecoder.h"
+
+/**
+ * @brief Madgwick orientation filter for accelerometer and gyroscope samples.
+ *
+ * Works one sample at a time on fixed-size Eigen types, nothing is allocated.
+ * The first sample initializes the attitude from the measured gravity, the time
+ * step is taken from the sample stamps.
+ */
+class MadgwickFilter
+{
+public:
+    /** beta weighs the accelerometer correction against the gyroscope integration. */
+    explicit MadgwickFilter(double beta = 0.1);
+
+    void update(const ImuSample &sample);
+    void update(const Eigen::Vector3d &acc, const Eigen::Vector3d &gyro, double dt);
+    void reset();
+
+    bool initialized() const { return initialized_; }
+    /** Rotation from the sensor frame into the earth frame (z up). */
+    const Eigen::Quaterniond &orientation() const { return q_; }
+    /** Roll, pitch, yaw in rad. */
+    Eigen::Vector3d eulerAngles() const;
+
+private:
+    double beta_;
+    bool initialized_;
+    double stamp_;
+    Eigen::Quaterniond q_;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef _OUTPUT_SINK_H__
+#define _OUTPUT_SINK_H__
+
+#include <chrono>
+#include <cstdio>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "serialReader.h"
+
+/**
+ * @brief Large write buffer for high rate text output to stdout or a rotating file.
+ *
+ * Use it as the streambuf of a std::ostream and end lines with '\n' instead of
+ * std::endl. The buffer is written out when it is full and, via tick(), when the
+ * oldest buffered data is older than the flush interval. A file is rotated to
+ * path.1 ... path.<keep> at a line boundary once it reaches rotateBytes. If the
+ * file cannot be reopened after a rotation, further output is discarded and
+ * failed() is set, an ostream on the sink then goes bad.
+ */
+class OutputSink : public std::streambuf
+{
+public:
+    explicit OutputSink(std::size_t bufferSize = 1 << 16,
+        std::chrono::milliseconds flushInterval = std::chrono::milliseconds(100));
+    ~OutputSink();
+
+    void openStdout();
+    bool openFile(const std::string &path, std::size_t rotateBytes = 0, int keep = 5);
+    void close();
+
+    void write(const char *data, std::size_t size);
+    void writeLine(const LineView &line);
+
+    /** Flushes if the flush interval has passed, call it regularly, also while idle. */
+    void tick();
+    void flush();
+
+    bool failed() const { return failed_; }
+
+protected:
+    int_type overflow(int_type ch);
+    std::streamsize xsputn(const char *s, std::streamsize n);
+    int sync();
+
+private:
+    OutputSink(const OutputSink &);
+    OutputSink &operator=(const OutputSink &);
+
+    void writeOut(const char *data, std::size_t size);
+    void rotate();
+
+    std::vector<char> buffer_;
+    std::chrono::milliseconds interval_;
+    std::chrono::steady_clock::time_point lastFlush_;
+    std::FILE *file_;
+    bool ownsFile_;
+    std::string path_;
+    std::size_t rotateBytes_;
+    int keep_;
+    std::size_t fileBytes_;
+    bool failed_;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef _PSEUDO_TERMINAL_H__
+#define _PSEUDO_TERMINAL_H__
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Raw pseudo-terminal pair that stands in for a SensorCube serial port.
+ *
+ * Data written to the master side is read from slaveName() by the serial tools,
+ * e.g. by pointing "serial_port" in the config at it. The slave is kept open so
+ * the master stays usable while tools connect and disconnect. Only available on
+ * Linux and macOS.
+ */
+class PseudoTerminal
+{
+public:
+    PseudoTerminal();
+    ~PseudoTerminal();
+
+    bool open();
+    void close();
+
+    bool isOpen() const { return master_ >= 0; }
+    const std::string &slaveName() const { return slaveName_; }
+    /** File descriptor of the master side. */
+    int fd() const { return master_; }
+
+    /** Writes all of data, blocking while the terminal buffer is full. */
+    bool write(const char *data, std::size_t size);
+    /** Reads what the tools sent to the port, returns -1 on error and 0 after timeoutMs without data. */
+    long read(char *data, std::size_t size, int timeoutMs = 0);
+
+private:
+    PseudoTerminal(const PseudoTerminal &);
+    PseudoTerminal &operator=(const PseudoTerminal &);
+
+    int master_;
+    int slave_;
+    std::string slaveName_;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef _QUEUED_SERIAL_READER_H__
+#define _QUEUED_SERIAL_READER_H__
+
+#include <asio/serial_port.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "ingestionEngine.h"
+#include "serialReader.h"
+#include "spscQueue.h"
+
+const std::size_t FRAMED_LINE_CAPACITY = 512;
+
+/**
+ * @brief Copy of one received line as it is passed between threads.
+ */
+struct FramedLine {
+    double received;    // host system clock in s when the line was framed
+    uint32_t port;
+    uint32_t size;
+    char data[FRAMED_LINE_CAPACITY];
+
+    LineView view() const { LineView v = {data, size}; return v; }
+    const char *begin() const { return data; }
+    const char *end() const { return data + size; }
+};
+
+/**
+ * @brief Reads serial ports on a background thread and hands lines over through an SpscQueue.
+ *
+ * The reader thread only frames lines, decoding and output happen on the consumer
+ * thread. When the consumer falls behind lines are dropped and counted instead of
+ * blocking the port. The reader thread ends when reading failed on all ports, see
+ * closed().
+ */
+class QueuedSerialReader
+{
+public:
+    explicit QueuedSerialReader(std::size_t slots = 4096);
+    ~QueuedSerialReader();
+
+    std::size_t addPort(const std::string &device, int baudrate);
+    asio::serial_port &port(std::size_t index) { return engine_.port(index); }
+    /** Writes to a port from the reader thread, safe while the reader runs. */
+    void write(std::size_t port, const std::string &data) { engine_.write(port, data); }
+
+    void start();
+    void stop();
+
+    /** Next line, waits up to about a millisecond and returns nullptr if there is none. */
+    const FramedLine *next();
+    /** Releases the line returned by next(). */
+    void pop() { queue_.pop(); }
+    /** True once the reader thread has ended and all its lines were consumed, next() stays nullptr. */
+    bool closed() const { return finished_.load(std::memory_order_acquire) && queue_.size() == 0; }
+
+    uint64_t received() const { return queue_.pushed(); }
+    uint64_t overflows() const { return queue_.overflows(); }
+    /** Lines dropped because they were longer than FRAMED_LINE_CAPACITY. */
+    uint64_t truncated() const { return truncated_.load(std::memory_order_relaxed); }
+    std::size_t backlog() const { return queue_.size(); }
+    /** Bytes the line framing of a port discarded, only valid after stop(). */
+    std::size_t droppedBytes(std::size_t port) const { return engine_.droppedBytes(port); }
+
+private:
+    void frame(std::size_t port, const LineView &line);
+
+    SpscQueue<FramedLine> queue_;
+    IngestionEngine engine_;
+    std::thread thread_;
+    std::atomic<uint64_t> truncated_;
+    std::atomic<bool> finished_;
+};
+
+#endif
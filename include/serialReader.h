@@ -0,0 +1,73 @@
+#ifndef _SERIAL_READER_H__
+#define _SERIAL_READER_H__
+
+#include <asio/serial_port.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Non-owning slice of a line inside a LineBuffer.
+ *
+ * Only valid until the next call that modifies the buffer.
+ */
+struct LineView {
+    const char *data;
+    std::size_t size;
+
+    bool empty() const { return size == 0; }
+    const char *begin() const { return data; }
+    const char *end() const { return data + size; }
+    std::string str() const { return std::string(data, size); }
+};
+
+/**
+ * @brief Fixed-size receive buffer that splits newline terminated messages in place.
+ *
+ * Bytes are written into prepare()/commit() and complete lines are handed out as
+ * LineViews pointing into the buffer. The storage is allocated once; consumed bytes
+ * are reclaimed by moving the pending partial line to the front of the buffer.
+ * Lines that do not fit into the buffer are dropped up to the next newline.
+ */
+class LineBuffer
+{
+public:
+    explicit LineBuffer(std::size_t capacity = 4096);
+
+    /** Returns the next complete line without trailing whitespace, false if none is buffered. */
+    bool nextLine(LineView &line);
+
+    /** Writable region for the next read, reclaims consumed space if necessary. */
+    char *prepare(std::size_t &size);
+    void commit(std::size_t size);
+
+    std::size_t droppedBytes() const { return dropped_; }
+
+private:
+    std::vector<char> buffer_;
+    std::size_t begin_;
+    std::size_t scan_;
+    std::size_t end_;
+    bool discarding_;
+    std::size_t dropped_;
+};
+
+/**
+ * @brief Blocking line reader for a SensorCube serial port.
+ */
+class SerialReader
+{
+public:
+    explicit SerialReader(asio::serial_port &port, std::size_t capacity = 4096);
+
+    /** Blocks until a complete line is available. Throws asio::system_error on read errors. */
+    LineView readLine();
+
+    std::size_t droppedBytes() const { return buffer_.droppedBytes(); }
+
+private:
+    asio::serial_port &port_;
+    LineBuffer buffer_;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef _SETTINGS_H__
+#define _SETTINGS_H__
+
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+/** Groups of keys a tool needs, missing keys of a required group fail loadSettings(). */
+enum SettingsGroup {
+    SETTINGS_SERIAL = 1,    // serial_port, serial_baudrate or serial_ports
+    SETTINGS_CAMERA = 2     // camera_index, camera_width, camera_height
+};
+
+struct SerialPortSettings {
+    std::string port;
+    int baudrate;
+};
+
+/**
+ * @brief Typed contents of config.json.
+ *
+ * serialPort is "serial_port" / "serial_baudrate", serialPorts the entries of
+ * "serial_ports". Each falls back to the other if only one of them is given.
+ */
+struct Settings {
+    unsigned int groups;    // SettingsGroup flags of the groups that are present
+    SerialPortSettings serialPort;
+    std::vector<SerialPortSettings> serialPorts;
+    unsigned int ingestionThreads;
+    int cameraIndex;
+    int cameraWidth;
+    int cameraHeight;
+
+    Settings();
+};
+
+/** Converts and validates a parsed config, false with a message naming the key on errors. */
+bool parseSettings(const nlohmann::json &config, Settings &settings, std::string &error);
+
+/**
+ * @brief Loads CONFIG_JSON_FILE_PATH once at startup and checks the required groups.
+ *
+ * Errors are printed and return false. If the build defines CONFIG_CACHE_FILE_PATH,
+ * the validated settings are cached there in binary form and reused as long as
+ * the config file's size and content hash do not change.
+ */
+bool loadSettings(Settings &settings, unsigned int required);
+bool loadSettings(const std::string &path, const std::string &cachePath, Settings &settings, unsigned int required);
+
+#endif
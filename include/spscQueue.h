@@ -0,0 +1,115 @@
+#ifndef _SPSC_QUEUE_H__
+#define _SPSC_QUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer and one consumer thread.
+ *
+ * All slots are allocated up front. The producer never blocks: if the queue is full
+ * the element is dropped and counted, so a slow consumer cannot stall the reader.
+ * Elements can be written and read in place to avoid copying large slots.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    /** capacity is rounded up to a power of two. */
+    explicit SpscQueue(std::size_t capacity)
+        : head_(0), tail_(0), pushed_(0), overflows_(0)
+    {
+        std::size_t n = 1;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        slots_.resize(n);
+        mask_ = n - 1;
+    }
+
+    // producer
+
+    /** Free slot to fill, nullptr (and an overflow is counted) if the queue is full. */
+    T *beginPush()
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    void commitPush()
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool push(const T &value)
+    {
+        T *slot = beginPush();
+        if (slot == nullptr) {
+            return false;
+        }
+        *slot = value;
+        commitPush();
+        return true;
+    }
+
+    // consumer
+
+    /** Oldest element, nullptr if the queue is empty. Valid until pop(). */
+    T *front()
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    void pop()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T &value)
+    {
+        T *slot = front();
+        if (slot == nullptr) {
+            return false;
+        }
+        // moved out, so a slot does not keep a reference counted element alive
+        value = std::move(*slot);
+        pop();
+        return true;
+    }
+
+    // any thread
+
+    std::size_t capacity() const { return slots_.size(); }
+    std::size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    uint64_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+    uint64_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+private:
+    SpscQueue(const SpscQueue &);
+    SpscQueue &operator=(const SpscQueue &);
+
+    std::vector<T> slots_;
+    std::size_t mask_;
+    // producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<std::size_t> head_;
+    alignas(64) std::atomic<std::size_t> tail_;
+    alignas(64) std::atomic<uint64_t> pushed_;
+    std::atomic<uint64_t> overflows_;
+};
+
+#endif
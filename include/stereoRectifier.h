@@ -0,0 +1,55 @@
+#ifndef _STEREO_RECTIFIER_H__
+#define _STEREO_RECTIFIER_H__
+
+#include <opencv2/core.hpp>
+#include <string>
+
+/**
+ * @brief Splits side-by-side stereo frames and rectifies both halves.
+ *
+ * The undistortion and rectification maps are computed once in fixed point
+ * (CV_16SC2 + CV_16UC1), which is the fastest input for cv::remap. Each frame is
+ * rectified directly into the two halves of a preallocated output image, in row
+ * bands of both halves at once, so nothing is allocated or copied per frame.
+ */
+class StereoRectifier
+{
+public:
+    /** bands is the number of row bands per half that are remapped in parallel. */
+    explicit StereoRectifier(int bands = 4);
+
+    /**
+     * Loads K1/D1/R1/P1 and K2/D2/R2/P2 from the "stereo" node of a calibration
+     * file like 9/calibration.yaml and builds the maps for frames of width x height,
+     * i.e. two halves of width / 2. If the halves differ from the calibrated image
+     * size, the camera matrices are scaled accordingly.
+     */
+    bool load(const std::string &path, int width, int height);
+
+    bool loaded() const { return !leftMap1_.empty(); }
+    int width() const { return 2 * halfSize_.width; }
+    int height() const { return halfSize_.height; }
+
+    /**
+     * Rectifies the frame into rectified, left half into the left half. rectified
+     * is allocated on first use only and must not share data with frame.
+     */
+    void rectify(const cv::Mat &frame, cv::Mat &rectified) const;
+
+    /** Left and right half of a side-by-side image, without copying. */
+    static cv::Mat left(const cv::Mat &image) { return image.colRange(0, image.cols / 2); }
+    static cv::Mat right(const cv::Mat &image) { return image.colRange(image.cols / 2, image.cols / 2 * 2); }
+
+    /** Rectified projection matrices, P2 holds the baseline as -f * b in (0, 3). */
+    const cv::Mat &projectionLeft() const { return P1_; }
+    const cv::Mat &projectionRight() const { return P2_; }
+
+private:
+    int bands_;
+    cv::Size halfSize_;
+    cv::Mat P1_, P2_;
+    cv::Mat leftMap1_, leftMap2_;
+    cv::Mat rightMap1_, rightMap2_;
+};
+
+#endif
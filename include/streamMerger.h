@@ -0,0 +1,202 @@
+#ifndef _STREAM_MERGER_H__
+#define _STREAM_MERGER_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief k-way merge of several time stamped streams into one stream in stamp order.
+ *
+ * Every source has a fixed ring of capacity items, which must arrive in stamp order
+ * per source. A min-heap over the sources' oldest items selects the next item. It is
+ * released once no open source can deliver anything older, i.e. every source
+ * without a buffered item has already delivered a stamp at least as new.
+ *
+ * A finite window is for live sources: a source whose last stamp is more than
+ * window seconds older than the newest stamp seen is stalled and not waited for,
+ * and a full buffer releases the head, as its reader cannot wait. With the default
+ * infinite window, for recorded files, the order is exact and the reader of a full
+ * buffer has to wait until the other sources caught up.
+ * Nothing is allocated after construction.
+ */
+template<typename T>
+class StreamMerger
+{
+public:
+    StreamMerger(std::size_t sources, std::size_t capacity, double window = std::numeric_limits<double>::infinity())
+        : sources_(sources), capacity_(capacity), window_(window),
+          newest_(-std::numeric_limits<double>::infinity()), released_(-std::numeric_limits<double>::infinity()),
+          first_(std::numeric_limits<double>::quiet_NaN()), waiting_(sources), late_(0)
+    {
+        for (Source &s : sources_) {
+            s.items.resize(capacity);
+            s.stamps.resize(capacity);
+            s.head = s.count = 0;
+            s.last = -std::numeric_limits<double>::infinity();
+            s.open = true;
+            s.pushed = false;
+        }
+        heap_.reserve(sources);
+    }
+
+    /** Slot for the next item of source, nullptr if its buffer is full. */
+    T *beginPush(std::size_t source)
+    {
+        Source &s = sources_[source];
+        if (s.count == capacity_) {
+            return nullptr;
+        }
+        return &s.items[(s.head + s.count) % capacity_];
+    }
+
+    void commitPush(std::size_t source, double stamp)
+    {
+        Source &s = sources_[source];
+        s.stamps[(s.head + s.count) % capacity_] = stamp;
+        if (s.count++ == 0) {
+            heapPush(source);
+            if (s.open) {
+                waiting_--;
+            }
+        }
+        s.last = stamp;
+        s.pushed = true;
+        if (std::isnan(first_)) {
+            first_ = stamp;
+        }
+        newest_ = std::max(newest_, stamp);
+        if (stamp < released_) {
+            late_++;
+        }
+    }
+
+    bool push(std::size_t source, double stamp, const T &item)
+    {
+        T *slot = beginPush(source);
+        if (slot == nullptr) {
+            return false;
+        }
+        *slot = item;
+        commitPush(source, stamp);
+        return true;
+    }
+
+    /** Marks the end of a source, e.g. the end of a recorded file. */
+    void close(std::size_t source)
+    {
+        Source &s = sources_[source];
+        if (s.open) {
+            s.open = false;
+            if (s.count == 0) {
+                waiting_--;
+            }
+        }
+    }
+
+    /** Next item in stamp order if it can be released, else nullptr. Valid until pop(). */
+    const T *front(std::size_t *source = nullptr, double *stamp = nullptr) const
+    {
+        if (heap_.empty()) {
+            return nullptr;
+        }
+        std::size_t i = heap_.front();
+        const Source &s = sources_[i];
+        double t = s.stamps[s.head];
+        if (waiting_ > 0 && blocked(t)) {
+            return nullptr;
+        }
+        if (source != nullptr) {
+            *source = i;
+        }
+        if (stamp != nullptr) {
+            *stamp = t;
+        }
+        return &s.items[s.head];
+    }
+
+    void pop()
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), Later(sources_));
+        std::size_t i = heap_.back();
+        heap_.pop_back();
+
+        Source &s = sources_[i];
+        released_ = std::max(released_, s.stamps[s.head]);
+        s.head = (s.head + 1) % capacity_;
+        if (--s.count > 0) {
+            heapPush(i);
+        } else if (s.open) {
+            waiting_++;
+        }
+    }
+
+    std::size_t size(std::size_t source) const { return sources_[source].count; }
+    bool isOpen(std::size_t source) const { return sources_[source].open; }
+    bool empty() const { return heap_.empty(); }
+    /** Items that arrived after a newer item had already been released. */
+    uint64_t late() const { return late_; }
+
+private:
+    struct Source {
+        std::vector<T> items;
+        std::vector<double> stamps;
+        std::size_t head;
+        std::size_t count;
+        double last;    // newest stamp pushed
+        bool open;
+        bool pushed;
+    };
+
+    // orders the heap by the oldest buffered stamp of each source
+    struct Later {
+        explicit Later(const std::vector<Source> &s) : sources(s) {}
+        bool operator()(std::size_t a, std::size_t b) const
+        {
+            return sources[a].stamps[sources[a].head] > sources[b].stamps[sources[b].head];
+        }
+        const std::vector<Source> &sources;
+    };
+
+    // true if a waiting source may still deliver an item older than t
+    bool blocked(double t) const
+    {
+        bool live = window_ < std::numeric_limits<double>::infinity();
+        double stalled = newest_ - window_;
+        bool blocked = false;
+        for (const Source &s : sources_) {
+            if (live && s.count == capacity_) {
+                return false;
+            }
+            if (s.open && s.count == 0) {
+                // a source that never delivered anything counts from the first stamp seen
+                double last = s.pushed ? s.last : first_;
+                if (last < t && last >= stalled) {
+                    blocked = true;
+                }
+            }
+        }
+        return blocked;
+    }
+
+    void heapPush(std::size_t source)
+    {
+        heap_.push_back(source);
+        std::push_heap(heap_.begin(), heap_.end(), Later(sources_));
+    }
+
+    std::vector<Source> sources_;
+    std::vector<std::size_t> heap_;
+    std::size_t capacity_;
+    double window_;
+    double newest_;
+    double released_;
+    double first_;
+    std::size_t waiting_;   // open sources without a buffered item
+    uint64_t late_;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "imuLog.h"
+#include "allanVariance.h"
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+
+int main(int argc, char *argv[])
+{
+    if (argc <= 1) {
+        std::cout << "Input file required!" << std::endl;
+        std::cout << "Usage: allanIMU <input file> [<points per decade>]" << std::endl;
+        return -1;
+    }
+    int pointsPerDecade = argc > 2 ? std::atoi(argv[2]) : 10;
+    if (pointsPerDecade < 1) {
+        std::cout << "Points per decade must be at least 1!" << std::endl;
+        std::cout << "Usage: allanIMU <input file> [<points per decade>]" << std::endl;
+        return -1;
+    }
+
+    ImuData imu;
+    if (!loadIMU(std::string(argv[1]), imu)) {
+        std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+        return -1;
+    }
+    std::cerr << "Loaded " << imu.size() << " IMU messages." << std::endl;
+
+    AllanDeviation result;
+    allanDeviation(imu, allanClusterSizes(imu.size(), pointsPerDecade), result);
+
+    // table for plotting: tau followed by the deviation of ax ay az wx wy wz
+    std::cout << "# tau ax ay az wx wy wz" << std::endl;
+    std::cout << std::setprecision(8);
+    for (Eigen::Index i = 0; i < result.tau.size(); i++) {
+        std::cout << result.tau[i];
+        for (int c = 0; c < IMU_CHANNELS; c++) {
+            std::cout << " " << result.adev(i, c);
+        }
+        std::cout << "\n";
+    }
+
+    // the flat bottom of the curve is the bias instability
+    const char *names[] = {"Acc X", "Acc Y", "Acc Z", "Gyr X", "Gyr Y", "Gyr Z"};
+    for (int c = 0; c < IMU_CHANNELS && result.tau.size() > 0; c++) {
+        Eigen::Index best;
+        double minimum = result.adev.col(c).minCoeff(&best);
+        std::cerr << names[c] << ": min. Allan deviation " << minimum << " at tau = " << result.tau[best] << " s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "allanVariance.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+template<typename F>
+void parallelFor(std::size_t tasks, unsigned int threads, F f)
+{
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        for (std::size_t task = next++; task < tasks; task = next++) {
+            f(task);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < std::min<std::size_t>(threads, tasks); i++) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (std::thread &t : workers) {
+        t.join();
+    }
+}
+
+}
+
+std::vector<Eigen::Index> allanClusterSizes(Eigen::Index n, int pointsPerDecade)
+{
+    std::vector<Eigen::Index> sizes;
+    if (pointsPerDecade < 1) {
+        return sizes;
+    }
+    Eigen::Index maxSize = (n - 1) / 2;
+    for (int i = 0; ; i++) {
+        Eigen::Index m = Eigen::Index(std::floor(std::pow(10.0, double(i) / pointsPerDecade)));
+        if (m > maxSize) {
+            break;
+        }
+        if (sizes.empty() || m != sizes.back()) {
+            sizes.push_back(m);
+        }
+    }
+    return sizes;
+}
+
+void allanDeviation(const ImuData &data, const std::vector<Eigen::Index> &clusterSizes, AllanDeviation &result,
+    double tau0, unsigned int threads)
+{
+    Eigen::Index n = data.size();
+    if (tau0 <= 0.0 && n > 1) {
+        tau0 = (data.t[n - 1] - data.t[0]) / double(n - 1);
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const Eigen::ArrayXd *channels[] = {&data.ax, &data.ay, &data.az, &data.wx, &data.wy, &data.wz};
+    std::size_t taus = clusterSizes.size();
+    result.tau.resize(taus);
+    result.adev.resize(taus, IMU_CHANNELS);
+    for (std::size_t i = 0; i < taus; i++) {
+        result.tau[i] = clusterSizes[i] * tau0;
+    }
+
+    // theta[k] = sum of the first k samples, the mean is removed to keep the sums small
+    std::vector<Eigen::ArrayXd> theta(IMU_CHANNELS);
+    parallelFor(IMU_CHANNELS, threads, [&](std::size_t c) {
+        const Eigen::ArrayXd &x = *channels[c];
+        double mean = x.mean();
+        Eigen::ArrayXd &th = theta[c];
+        th.resize(n + 1);
+        th[0] = 0.0;
+        for (Eigen::Index k = 0; k < n; k++) {
+            th[k + 1] = th[k] + (x[k] - mean);
+        }
+    });
+
+    // avar(m) = sum_k (theta[k+2m] - 2 theta[k+m] + theta[k])^2 / (2 m^2 (n - 2m + 1))
+    parallelFor(IMU_CHANNELS * taus, threads, [&](std::size_t task) {
+        std::size_t c = task % IMU_CHANNELS;
+        std::size_t i = task / IMU_CHANNELS;
+        Eigen::Index m = clusterSizes[i];
+        Eigen::Index terms = n - 2 * m + 1;
+        if (m <= 0 || terms <= 0) {
+            result.adev(i, c) = std::nan("");
+            return;
+        }
+
+        const Eigen::ArrayXd &th = theta[c];
+        double sum = (th.segment(2 * m, terms) - 2.0 * th.segment(m, terms) + th.head(terms)).square().sum();
+        result.adev(i, c) = std::sqrt(sum / (2.0 * double(m) * double(m) * double(terms)));
+    });
+}
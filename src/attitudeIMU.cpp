@@ -0,0 +1,102 @@
+#include <asio/serial_port.hpp>
+#include <asio/write.hpp>
+#include "serialReader.h"
+#include "messageDecoder.h"
+#include "imuLog.h"
+#include "orientationFilter.h"
+#include "settings.h"
+#include <iostream>
+#include <iomanip>
+#include <csignal>
+
+
+sig_atomic_t volatile running = true;
+void sigHandler(int signum)
+{
+    if (signum == SIGINT) {
+        running = false;
+    }
+}
+
+void printAttitude(const ImuSample &sample, const MadgwickFilter &filter)
+{
+    Eigen::Vector3d rpy = filter.eulerAngles() * (180.0 / M_PI);
+    std::cout << std::setiosflags(std::ios_base::fixed) << std::setprecision(3) << sample.stamp
+        << " roll " << rpy.x() << " pitch " << rpy.y() << " yaw " << rpy.z() << '\n';
+}
+
+int main(int argc, char *argv[])
+{
+    MadgwickFilter filter;
+
+    // offline: run the filter over a log or recording
+    if (argc > 1) {
+        bool ok = streamIMU(argv[1], [&filter](const ImuSample &s) {
+            filter.update(s);
+            printAttitude(s, filter);
+        });
+        if (!ok) {
+            std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    signal(SIGINT, &sigHandler);
+
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_SERIAL)) {
+        return -1;
+    }
+
+    std::cout << "Opening port " << settings.serialPort.port << " with baudrate " << settings.serialPort.baudrate << "." << std::endl;
+    asio::io_context ctx;
+    asio::serial_port sensorcube(ctx);
+    sensorcube.open(settings.serialPort.port);
+    sensorcube.set_option(asio::serial_port::baud_rate(settings.serialPort.baudrate));
+    sensorcube.set_option(asio::serial_port::flow_control(asio::serial_port::flow_control::none));
+    sensorcube.set_option(asio::serial_port::character_size(8));
+    sensorcube.set_option(asio::serial_port::parity(asio::serial_port::parity::none));
+    sensorcube.set_option(asio::serial_port::stop_bits(asio::serial_port::stop_bits::one));
+
+    std::string command = "{\"messages\":[\"imu_raw\"]}\r\n";
+    asio::write(sensorcube, asio::buffer(command.data(), command.length()));
+
+    SerialReader reader(sensorcube);
+    // skip the first, possibly incomplete line
+    reader.readLine();
+
+    Message msg;
+    unsigned long failed = 0;
+    while (running) {
+        LineView line;
+        try {
+            line = reader.readLine();
+        } catch (...) {
+            if (running) {
+                std::cerr << "Error: Failed reading from serial port!" << std::endl;
+            }
+            continue;
+        }
+
+        // a noisy port produces malformed lines, they are skipped
+        MessageType type;
+        try {
+            type = decodeMessage(line.begin(), line.end(), msg);
+        } catch (...) {
+            failed++;
+            continue;
+        }
+        if (type == MessageType::ImuRaw) {
+            filter.update(msg.imu);
+            printAttitude(msg.imu, filter);
+        }
+    }
+
+    std::cout.flush();
+    if (failed > 0) {
+        std::cerr << "Warning: " << failed << " lines could not be decoded!" << std::endl;
+    }
+
+    return 0;
+}
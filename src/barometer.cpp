@@ -0,0 +1,80 @@
+#include "barometer.h"
+#include <cmath>
+
+namespace {
+
+const double ALTITUDE_SCALE = 145366.45 * 0.3048;
+const double ALTITUDE_EXPONENT = 0.190284;
+
+}
+
+double pressureAltitude(double pressure, double seaLevel)
+{
+    return ALTITUDE_SCALE * (1.0 - std::pow(pressure / seaLevel, ALTITUDE_EXPONENT));
+}
+
+Eigen::ArrayXd pressureAltitude(const Eigen::ArrayXd &pressure, double seaLevel)
+{
+    return ALTITUDE_SCALE * (1.0 - (ALTITUDE_EXPONENT * (pressure / seaLevel).log()).exp());
+}
+
+AltitudeTable::AltitudeTable(double seaLevel, double minPressure, double maxPressure, double step)
+    : seaLevel_(seaLevel), min_(minPressure), invStep_(1.0 / step)
+{
+    std::size_t n = std::size_t(std::ceil((maxPressure - minPressure) * invStep_)) + 1;
+    max_ = minPressure + (n - 1) * step;
+
+    Eigen::ArrayXd altitude = pressureAltitude(Eigen::ArrayXd::LinSpaced(n, min_, max_), seaLevel);
+    altitude_.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+        altitude_[i] = float(altitude[i]);
+    }
+}
+
+double AltitudeTable::operator()(double pressure) const
+{
+    if (!(pressure >= min_ && pressure < max_)) {
+        return pressureAltitude(pressure, seaLevel_);
+    }
+    double x = (pressure - min_) * invStep_;
+    std::size_t i = std::size_t(x);
+    double f = x - double(i);
+    return altitude_[i] + f * (altitude_[i + 1] - altitude_[i]);
+}
+
+Eigen::ArrayXd AltitudeTable::operator()(const Eigen::ArrayXd &pressure) const
+{
+    Eigen::ArrayXd altitude(pressure.size());
+    for (Eigen::Index i = 0; i < pressure.size(); i++) {
+        altitude[i] = (*this)(pressure[i]);
+    }
+    return altitude;
+}
+
+AltitudeFilter::AltitudeFilter(double timeConstant)
+    : tau_(timeConstant)
+{
+    reset();
+}
+
+double AltitudeFilter::update(double stamp, double altitude)
+{
+    if (!initialized_) {
+        initialized_ = true;
+        altitude_ = altitude;
+    } else if (tau_ <= 0.0) {
+        altitude_ = altitude;
+    } else if (stamp > stamp_) {
+        double dt = stamp - stamp_;
+        altitude_ += dt / (tau_ + dt) * (altitude - altitude_);
+    }
+    stamp_ = stamp;
+    return altitude_;
+}
+
+void AltitudeFilter::reset()
+{
+    initialized_ = false;
+    stamp_ = 0.0;
+    altitude_ = 0.0;
+}
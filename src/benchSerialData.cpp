@@ -0,0 +1,162 @@
+#include "queuedSerialReader.h"
+#include "messageDecoder.h"
+#include "linkMonitor.h"
+#include "pseudoTerminal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+double systemTime()
+{
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// synthetic SensorCube traffic, stamped with the host time at generation
+std::size_t generateLine(char *out, std::size_t size, MessageType type, unsigned long seq)
+{
+    double stamp = systemTime();
+    int n;
+    if (type == MessageType::ImuRaw) {
+        n = std::snprintf(out, size,
+            "{\"msg\": \"imu_raw\", \"stamp\": %.7f, \"seq\": %lu, \"wx\": 0.0029982045760221054, \"wy\": 0.00020984752732891072, \"wz\": 0.002156395718482303, \"ax\": -0.11839278042316437, \"ay\": 9.748122215270996, \"az\": 0.016663771122694016}\r\n",
+            stamp, seq);
+    } else if (type == MessageType::Heartbeat) {
+        n = std::snprintf(out, size, "{\"msg\": \"heartbeat\", \"stamp\": %.7f, \"seq\": %lu}\r\n", stamp, seq);
+    } else {
+        n = std::snprintf(out, size, "{\"msg\": \"pressure_raw\", \"stamp\": %.7f, \"seq\": %lu, \"pressure\": 95123}\r\n", stamp, seq);
+    }
+    return std::size_t(n);
+}
+
+void printStage(const char *name, const LatencyHistogram &h)
+{
+    std::cout << name << " latency (us): p50 " << h.percentile(0.5) << ", p99 " << h.percentile(0.99)
+        << ", p99.9 " << h.percentile(0.999) << ", max " << h.max() << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    double rate = argc > 1 ? std::strtod(argv[1], nullptr) : 0.0;
+    double duration = argc > 2 ? std::strtod(argv[2], nullptr) : 5.0;
+    unsigned int mix[3] = {8, 1, 1};
+    if (argc > 3 && std::sscanf(argv[3], "%u:%u:%u", &mix[0], &mix[1], &mix[2]) != 3) {
+        std::cout << "Usage: benchSerialData [<lines per s, 0 = as fast as possible> [<seconds> [<imu:heartbeat:pressure>]]]" << std::endl;
+        return -1;
+    }
+    if (!(duration > 0.0) || mix[0] + mix[1] + mix[2] == 0) {
+        std::cerr << "Error: Invalid benchmark parameters!" << std::endl;
+        return -1;
+    }
+
+    // the message mix is repeated as a fixed pattern, e.g. 8 imu, 1 heartbeat, 1 pressure
+    std::vector<MessageType> pattern;
+    pattern.insert(pattern.end(), mix[0], MessageType::ImuRaw);
+    pattern.insert(pattern.end(), mix[1], MessageType::Heartbeat);
+    pattern.insert(pattern.end(), mix[2], MessageType::PressureRaw);
+
+    PseudoTerminal pty;
+    if (!pty.open()) {
+        std::cerr << "Error: Unable to open a pseudo-terminal!" << std::endl;
+        return -1;
+    }
+    QueuedSerialReader reader;
+    reader.addPort(pty.slaveName(), 115200);
+    reader.start();
+
+    std::atomic<bool> generating(true);
+    uint64_t generatedLines = 0, generatedBytes = 0;
+    std::thread generator([&]() {
+        std::vector<char> chunk(1 << 16);
+        // the engine skips the first line of a port, it may be incomplete on real hardware
+        pty.write("\r\n", 2);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point end = start
+            + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(duration));
+        while (true) {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (now >= end) {
+                break;
+            }
+            uint64_t target = rate > 0.0 ? uint64_t(std::chrono::duration<double>(now - start).count() * rate) : generatedLines + 256;
+            std::size_t used = 0;
+            while (generatedLines < target && chunk.size() - used >= 512) {
+                used += generateLine(chunk.data() + used, chunk.size() - used, pattern[generatedLines % pattern.size()], generatedLines);
+                generatedLines++;
+            }
+            if (used > 0) {
+                pty.write(chunk.data(), used);
+                generatedBytes += used;
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        generating = false;
+    });
+
+    LatencyHistogram framing, processing;
+    uint64_t decoded[5] = {0, 0, 0, 0, 0};
+    uint64_t failed = 0, receivedBytes = 0;
+    double decodeTime = 0.0;
+    std::chrono::steady_clock::time_point idleSince = std::chrono::steady_clock::now();
+    Message msg;
+    while (true) {
+        const FramedLine *line = reader.next();
+        if (line == nullptr) {
+            // wait for the tail of the traffic once the generator is done
+            if (!generating && std::chrono::steady_clock::now() - idleSince > std::chrono::milliseconds(200)) {
+                break;
+            }
+            continue;
+        }
+        idleSince = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        bool ok = true;
+        try {
+            decoded[int(decodeMessage(line->begin(), line->end(), msg))]++;
+        } catch (...) {
+            ok = false;
+            failed++;
+        }
+        decodeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        double now = systemTime();
+        if (ok && !std::isnan(msg.stamp)) {
+            framing.record(uint64_t(std::max(0.0, line->received - msg.stamp) * 1e6));
+        }
+        processing.record(uint64_t(std::max(0.0, now - line->received) * 1e6));
+        receivedBytes += line->size + 2;
+        reader.pop();
+    }
+    generator.join();
+    reader.stop();
+
+    uint64_t lines = reader.received();
+    std::cout << "Generated " << generatedLines << " lines (" << generatedBytes / 1024 << " KiB) in " << duration << " s, "
+        << generatedLines / duration << " lines/s." << std::endl;
+    std::cout << "Received " << lines << " lines: " << decoded[int(MessageType::ImuRaw)] << " imu, "
+        << decoded[int(MessageType::Heartbeat)] << " heartbeat, " << decoded[int(MessageType::PressureRaw)] << " pressure, "
+        << failed << " failed." << std::endl;
+    std::cout << "Decode throughput: " << (decodeTime > 0.0 ? double(lines) / decodeTime : 0.0) << " lines/s, "
+        << (lines > 0 ? decodeTime / double(lines) * 1e9 : 0.0) << " ns/line." << std::endl;
+    printStage("Generation to framing", framing);
+    printStage("Framing to decoded", processing);
+    std::cout << "Dropped: " << reader.overflows() << " lines in the queue, " << reader.droppedBytes(0)
+        << " bytes in the line buffer, " << reader.truncated() << " lines too long, "
+        << (generatedBytes > receivedBytes ? generatedBytes - receivedBytes : 0) << " bytes missing in total." << std::endl;
+
+    return 0;
+}
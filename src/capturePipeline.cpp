@@ -0,0 +1,129 @@
+#include "capturePipeline.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// host system clock time of the grabbed frame, the clock the serial lines are stamped with
+double frameTime(cv::VideoCapture &capture)
+{
+    double systemNow = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+#ifdef LINUX_OS
+    // V4L2 stamps its buffers with CLOCK_MONOTONIC, which is steady_clock on Linux
+    double monotonicNow = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    double buffer = capture.get(cv::CAP_PROP_POS_MSEC) / 1000.0;
+    if (buffer > 0.0 && std::fabs(monotonicNow - buffer) < 1.0) {
+        return systemNow - (monotonicNow - buffer);
+    }
+#endif
+    return systemNow;
+}
+
+}
+
+FrameRef FrameConsumer::next(int timeoutMs)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    FrameRef frame;
+    // frames arrive at camera rate, polling with a short sleep costs nothing noticeable
+    while (!queue_.pop(frame)) {
+        if (std::chrono::steady_clock::now() >= end) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    return frame;
+}
+
+CapturePipeline::CapturePipeline(std::size_t poolSize)
+    : poolSize_(poolSize), running_(false), stopping_(false), width_(0), height_(0), captured_(0), exhausted_(0)
+{
+}
+
+CapturePipeline::~CapturePipeline()
+{
+    stop();
+}
+
+bool CapturePipeline::open(const Settings &settings)
+{
+    int apiPreference = cv::CAP_ANY;
+#ifdef LINUX_OS
+    apiPreference = cv::CAP_V4L;
+#endif
+
+    capture_.open(settings.cameraIndex, apiPreference);
+    capture_.set(cv::CAP_PROP_FRAME_WIDTH, settings.cameraWidth);
+    capture_.set(cv::CAP_PROP_FRAME_HEIGHT, settings.cameraHeight);
+    int fourcc = cv::VideoWriter::fourcc('B', 'G', 'R', '3');
+    capture_.set(cv::CAP_PROP_FOURCC, fourcc);
+    if (!capture_.isOpened()) {
+        return false;
+    }
+
+    // the camera may not deliver the requested size, so the first frame sizes the pool
+    cv::Mat first;
+    if (!capture_.read(first) || first.empty()) {
+        return false;
+    }
+    width_ = first.cols;
+    height_ = first.rows;
+    pool_.reset(new FramePool(poolSize_, first.rows, first.cols, first.type()));
+    return true;
+}
+
+FrameConsumer &CapturePipeline::addConsumer(std::size_t capacity)
+{
+    consumers_.emplace_back(capacity);
+    return consumers_.back();
+}
+
+void CapturePipeline::start()
+{
+    stopping_ = false;
+    running_ = true;
+    thread_ = std::thread([this]() { grab(); });
+}
+
+void CapturePipeline::stop()
+{
+    stopping_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    running_ = false;
+}
+
+void CapturePipeline::grab()
+{
+    uint64_t seq = 0;
+    while (!stopping_.load(std::memory_order_acquire)) {
+        // always take the image off the driver, otherwise it queues up stale frames
+        if (!capture_.grab()) {
+            std::cerr << "Error: Blank frame grabbed!" << std::endl;
+            break;
+        }
+        double stamp = frameTime(capture_);
+
+        std::shared_ptr<Frame> frame = pool_->acquire();
+        if (!frame) {
+            exhausted_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        // retrieve() decodes into the pooled buffer, it only reallocates if the format changes
+        if (!capture_.retrieve(frame->image) || frame->image.empty()) {
+            std::cerr << "Error: Blank frame grabbed!" << std::endl;
+            break;
+        }
+        frame->seq = seq++;
+        frame->stamp = stamp;
+        captured_.fetch_add(1, std::memory_order_relaxed);
+
+        FrameRef shared = frame;
+        for (FrameConsumer &c : consumers_) {
+            c.queue_.push(shared);
+        }
+    }
+    running_.store(false, std::memory_order_release);
+}
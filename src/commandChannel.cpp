@@ -0,0 +1,108 @@
+#include "commandChannel.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+
+using json = nlohmann::json;
+
+CommandChannel::CommandChannel(Writer writer, double timeout, int retries, double settle)
+    : writer_(writer),
+      timeout_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout))),
+      settle_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(settle))),
+      retries_(retries), pending_(false), failed_(false), attempts_(0), commands_(0), resent_(0)
+{
+}
+
+void CommandChannel::subscribe(const std::string &type)
+{
+    std::vector<std::string>::iterator it = std::lower_bound(wanted_.begin(), wanted_.end(), type);
+    if (it == wanted_.end() || *it != type) {
+        wanted_.insert(it, type);
+    }
+}
+
+void CommandChannel::unsubscribe(const std::string &type)
+{
+    std::vector<std::string>::iterator it = std::lower_bound(wanted_.begin(), wanted_.end(), type);
+    if (it != wanted_.end() && *it == type) {
+        wanted_.erase(it);
+    }
+}
+
+void CommandChannel::setSubscriptions(const std::vector<std::string> &types)
+{
+    wanted_ = types;
+    std::sort(wanted_.begin(), wanted_.end());
+    wanted_.erase(std::unique(wanted_.begin(), wanted_.end()), wanted_.end());
+}
+
+void CommandChannel::flush()
+{
+    if (commands_ > 0 && wanted_ == sent_) {
+        return;
+    }
+    sent_ = wanted_;
+    attempts_ = 0;
+    failed_ = false;
+    send();
+}
+
+void CommandChannel::send()
+{
+    // built with nlohmann so the type names are escaped
+    json command;
+    command["messages"] = sent_;
+    writer_(command.dump() + "\r\n");
+
+    commands_++;
+    attempts_++;
+    pending_ = true;
+    waiting_ = sent_;
+    sentAt_ = std::chrono::steady_clock::now();
+    lastUnwanted_ = sentAt_;
+}
+
+bool CommandChannel::contains(const std::vector<std::string> &set, const char *type)
+{
+    for (const std::string &s : set) {
+        if (std::strcmp(s.c_str(), type) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CommandChannel::received(const char *type)
+{
+    if (!pending_ || type[0] == '\0') {
+        return;
+    }
+    for (std::size_t i = 0; i < waiting_.size(); i++) {
+        if (std::strcmp(waiting_[i].c_str(), type) == 0) {
+            waiting_.erase(waiting_.begin() + i);
+            return;
+        }
+    }
+    if (!contains(sent_, type)) {
+        lastUnwanted_ = std::chrono::steady_clock::now();
+    }
+}
+
+void CommandChannel::tick()
+{
+    if (!pending_) {
+        return;
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (waiting_.empty() && now - lastUnwanted_ >= settle_) {
+        pending_ = false;
+    } else if (now - sentAt_ >= timeout_) {
+        if (attempts_ > retries_) {
+            pending_ = false;
+            failed_ = true;
+        } else {
+            resent_++;
+            send();
+        }
+    }
+}
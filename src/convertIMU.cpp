@@ -0,0 +1,67 @@
+#include "mappedFile.h"
+#include "messageDecoder.h"
+#include "imuRecord.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+
+// larger blocks only cost memory, the index already makes seeking cheap
+const unsigned long MAX_BLOCK_CAPACITY = 1 << 20;
+
+int main(int argc, char *argv[])
+{
+    if (argc <= 2) {
+        std::cout << "Input and output file required!" << std::endl;
+        std::cout << "Usage: convertIMU <input file> <output file> [<samples per block>]" << std::endl;
+        return -1;
+    }
+
+    unsigned long blockCapacity = 4096;
+    if (argc > 3) {
+        char *end;
+        blockCapacity = std::strtoul(argv[3], &end, 10);
+        if (end == argv[3] || *end != '\0' || argv[3][0] == '-' || blockCapacity == 0 || blockCapacity > MAX_BLOCK_CAPACITY) {
+            std::cout << "Samples per block must be a number from 1 to " << MAX_BLOCK_CAPACITY << "!" << std::endl;
+            std::cout << "Usage: convertIMU <input file> <output file> [<samples per block>]" << std::endl;
+            return -1;
+        }
+    }
+
+    MappedFile in;
+    if (!in.open(argv[1])) {
+        std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+        return -1;
+    }
+
+    ImuRecordWriter out(static_cast<uint32_t>(blockCapacity));
+    if (!out.open(argv[2])) {
+        std::cerr << "Error: Unable to open " << argv[2] << "!" << std::endl;
+        return -1;
+    }
+
+    // stream the mapped log line by line, nothing but one block is held in memory
+    Message msg;
+    unsigned long lines = 0, samples = 0;
+    const char *p = in.data();
+    const char *end = p + in.size();
+    while (p < end) {
+        const char *nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char *lineEnd = nl != nullptr ? nl : end;
+        lines++;
+        try {
+            if (lineEnd > p && decodeMessage(p, lineEnd, msg) == MessageType::ImuRaw) {
+                out.write(msg.imu);
+                samples++;
+            }
+        } catch (...) {
+            std::cerr << "Error: Failed to parse line " << lines << "!" << std::endl;
+        }
+        p = lineEnd + 1;
+    }
+    out.close();
+
+    std::cout << "Converted " << samples << " IMU messages from " << lines << " lines." << std::endl;
+
+    return 0;
+}
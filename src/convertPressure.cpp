@@ -0,0 +1,65 @@
+#include "mappedFile.h"
+#include "messageDecoder.h"
+#include "barometer.h"
+#include "outputSink.h"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+
+int main(int argc, char *argv[])
+{
+    if (argc <= 1) {
+        std::cout << "Input file required!" << std::endl;
+        std::cout << "Usage: convertPressure <input file> [<smoothing time constant in s>]" << std::endl;
+        return -1;
+    }
+
+    MappedFile in;
+    if (!in.open(argv[1])) {
+        std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+        return -1;
+    }
+    double timeConstant = argc > 2 ? std::strtod(argv[2], nullptr) : 0.5;
+
+    // collect the pressure samples of the log, then convert them in one batch
+    std::vector<double> stamps, pressures;
+    Message msg;
+    unsigned long lines = 0;
+    const char *p = in.data();
+    const char *end = p + in.size();
+    while (p < end) {
+        const char *nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char *lineEnd = nl != nullptr ? nl : end;
+        lines++;
+        try {
+            if (lineEnd > p && decodeMessage(p, lineEnd, msg) == MessageType::PressureRaw) {
+                stamps.push_back(msg.pressure.stamp);
+                pressures.push_back(double(msg.pressure.pressure));
+            }
+        } catch (...) {
+            std::cerr << "Error: Failed to parse line " << lines << "!" << std::endl;
+        }
+        p = lineEnd + 1;
+    }
+
+    Eigen::Index n = Eigen::Index(pressures.size());
+    Eigen::ArrayXd altitude = pressureAltitude(Eigen::Map<const Eigen::ArrayXd>(pressures.data(), n));
+
+    OutputSink sink;
+    sink.openStdout();
+    std::ostream out(&sink);
+    out << std::setiosflags(std::ios_base::fixed) << std::setprecision(3);
+    out << "stamp,pressure,altitude,smoothed\n";
+    AltitudeFilter filter(timeConstant);
+    for (Eigen::Index i = 0; i < n; i++) {
+        out << stamps[i] << ',' << pressures[i] << ',' << altitude[i] << ',' << filter.update(stamps[i], altitude[i]) << '\n';
+    }
+    sink.flush();
+
+    std::cerr << "Converted " << n << " pressure messages from " << lines << " lines." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "disparityEngine.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cstdio>
+
+DisparityEngine::DisparityEngine(int numDisparities, int blockSize, int bands)
+    : numDisparities_((std::max(numDisparities, 16) + 15) / 16 * 16), blockSize_(std::max(blockSize, 1) | 1),
+      f_(0.0), cx_(0.0), cy_(0.0), baseline_(0.0), dcx_(0.0)
+{
+    bands_.resize(std::max(bands, 1));
+    bandPoints_.resize(bands_.size());
+    int area = blockSize_ * blockSize_;
+    for (std::size_t i = 0; i < bands_.size(); i++) {
+        bands_[i].matcher = cv::StereoSGBM::create(0, numDisparities_, blockSize_, 8 * area, 32 * area,
+            1, 63, 10, 100, 2, cv::StereoSGBM::MODE_SGBM_3WAY);
+    }
+}
+
+void DisparityEngine::setProjection(const cv::Mat &P1, const cv::Mat &P2)
+{
+    f_ = P1.at<double>(0, 0);
+    cx_ = P1.at<double>(0, 2);
+    cy_ = P1.at<double>(1, 2);
+    baseline_ = -P2.at<double>(0, 3) / P2.at<double>(0, 0);
+    dcx_ = P1.at<double>(0, 2) - P2.at<double>(0, 2);
+}
+
+void DisparityEngine::compute(const cv::Mat &rectified, cv::Mat &disparity)
+{
+    int width = rectified.cols / 2;
+    int rows = rectified.rows;
+    cv::Mat left = rectified.colRange(0, width);
+    cv::Mat right = rectified.colRange(width, 2 * width);
+    if (rectified.channels() == 3) {
+        cv::cvtColor(left, left_, cv::COLOR_BGR2GRAY);
+        cv::cvtColor(right, right_, cv::COLOR_BGR2GRAY);
+        left = left_;
+        right = right_;
+    }
+    disparity.create(rows, width, CV_16S);
+
+    // the bands overlap, so the block matching and the path costs see context across their borders
+    int count = int(bands_.size());
+    int margin = 2 * blockSize_;
+    cv::parallel_for_(cv::Range(0, count), [&](const cv::Range &range) {
+        for (int i = range.start; i < range.end; i++) {
+            int begin = rows * i / count;
+            int end = rows * (i + 1) / count;
+            int top = std::max(begin - margin, 0);
+            int bottom = std::min(end + margin, rows);
+            Band &band = bands_[i];
+            band.matcher->compute(left.rowRange(top, bottom), right.rowRange(top, bottom), band.disparity);
+            cv::Mat out = disparity.rowRange(begin, end);
+            band.disparity.rowRange(begin - top, end - top).copyTo(out);
+        }
+    });
+}
+
+void DisparityEngine::reproject(const cv::Mat &disparity, std::vector<cv::Point3f> &points, float maxDepth) const
+{
+    int count = int(bandPoints_.size());
+    int rows = disparity.rows;
+    cv::parallel_for_(cv::Range(0, count), [&](const cv::Range &range) {
+        for (int i = range.start; i < range.end; i++) {
+            std::vector<cv::Point3f> &out = bandPoints_[i];
+            out.clear();
+            for (int y = rows * i / count; y < rows * (i + 1) / count; y++) {
+                const short *row = disparity.ptr<short>(y);
+                for (int x = 0; x < disparity.cols; x++) {
+                    if (row[x] <= 0) {
+                        continue;
+                    }
+                    double w = baseline_ / (row[x] / 16.0 - dcx_);
+                    float z = float(f_ * w);
+                    if (z <= 0.0f || z > maxDepth) {
+                        continue;
+                    }
+                    out.push_back(cv::Point3f(float((x - cx_) * w), float((y - cy_) * w), z));
+                }
+            }
+        }
+    });
+
+    points.clear();
+    for (int i = 0; i < count; i++) {
+        points.insert(points.end(), bandPoints_[i].begin(), bandPoints_[i].end());
+    }
+}
+
+bool writePointCloud(const std::string &path, const std::vector<cv::Point3f> &points)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == NULL) {
+        return false;
+    }
+    for (std::size_t i = 0; i < points.size(); i++) {
+        fprintf(file, "%f %f %f\n", points[i].x, points[i].y, points[i].z);
+    }
+    return fclose(file) == 0;
+}
@@ -0,0 +1,39 @@
+#include "framePool.h"
+
+FramePool::FramePool(std::size_t count, int rows, int cols, int type)
+    : state_(std::make_shared<State>())
+{
+    state_->frames.resize(count);
+    state_->free.reserve(count);
+    for (Frame &f : state_->frames) {
+        f.image.create(rows, cols, type);
+        f.seq = 0;
+        f.stamp = 0.0;
+        state_->free.push_back(&f);
+    }
+}
+
+std::shared_ptr<Frame> FramePool::acquire()
+{
+    Frame *frame;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->free.empty()) {
+            return std::shared_ptr<Frame>();
+        }
+        frame = state_->free.back();
+        state_->free.pop_back();
+    }
+
+    std::shared_ptr<State> state = state_;
+    return std::shared_ptr<Frame>(frame, [state](Frame *f) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->free.push_back(f);
+    });
+}
+
+std::size_t FramePool::available() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->free.size();
+}
@@ -0,0 +1,166 @@
+#include "frameRecorder.h"
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <cstring>
+
+FrameRecorder::FrameRecorder(FrameFormat format, unsigned int workers, std::size_t queueSize)
+    : format_(format), workerCount_(workers), queueSize_(queueSize), raw_(nullptr), closing_(false),
+      written_(0), dropped_(0), failed_(0)
+{
+    if (workerCount_ == 0) {
+        workerCount_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (format_ == FrameFormat::Raw) {
+        workerCount_ = 1;
+    }
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+bool FrameRecorder::open(const std::string &directory)
+{
+    close();
+    directory_ = directory;
+
+    if (format_ == FrameFormat::Raw) {
+        raw_ = std::fopen((directory_ + "/frames.raw").c_str(), "wb");
+        if (raw_ == nullptr) {
+            return false;
+        }
+        FrameFileHeader header;
+        std::memcpy(header.magic, FRAME_FILE_MAGIC, sizeof(header.magic));
+        header.version = FRAME_FILE_VERSION;
+        header.reserved = 0;
+        std::fwrite(&header, sizeof(header), 1, raw_);
+    }
+
+    closing_ = false;
+    for (unsigned int i = 0; i < workerCount_; i++) {
+        workers_.push_back(std::thread([this]() { work(); }));
+    }
+    return true;
+}
+
+void FrameRecorder::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+    }
+    ready_.notify_all();
+    for (std::thread &t : workers_) {
+        t.join();
+    }
+    workers_.clear();
+
+    if (raw_ != nullptr) {
+        std::fclose(raw_);
+        raw_ = nullptr;
+    }
+}
+
+bool FrameRecorder::write(const FrameRef &frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (workers_.empty() || queue_.size() >= queueSize_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        queue_.push_back(frame);
+    }
+    ready_.notify_one();
+    return true;
+}
+
+std::size_t FrameRecorder::backlog()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void FrameRecorder::work()
+{
+    std::vector<unsigned char> buffer;
+    while (true) {
+        FrameRef frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this]() { return closing_ || !queue_.empty(); });
+            // the queue is written out before the workers stop
+            if (queue_.empty()) {
+                return;
+            }
+            frame = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        if (store(*frame, buffer)) {
+            written_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool FrameRecorder::store(const Frame &frame, std::vector<unsigned char> &buffer)
+{
+    const cv::Mat &image = frame.image;
+    if (format_ == FrameFormat::Raw) {
+        FrameRecordHeader header;
+        header.seq = frame.seq;
+        header.stamp = frame.stamp;
+        header.rows = image.rows;
+        header.cols = image.cols;
+        header.type = image.type();
+        header.reserved = 0;
+        header.bytes = uint64_t(image.rows) * image.cols * image.elemSize();
+        bool ok = std::fwrite(&header, sizeof(header), 1, raw_) == 1;
+        std::size_t rowBytes = std::size_t(image.cols) * image.elemSize();
+        for (int r = 0; ok && r < image.rows; r++) {
+            ok = std::fwrite(image.ptr<unsigned char>(r), 1, rowBytes, raw_) == rowBytes;
+        }
+        return ok;
+    }
+
+    // encoded into a per worker buffer, only the file write touches the disk
+    char name[32];
+    std::snprintf(name, sizeof(name), "/frame_%08llu", (unsigned long long)frame.seq);
+    std::string path = directory_ + name;
+    std::vector<int> params;
+    if (format_ == FrameFormat::Png) {
+        path += ".png";
+        params.push_back(cv::IMWRITE_PNG_COMPRESSION);
+        params.push_back(1);
+    } else {
+        path += ".jpg";
+        params.push_back(cv::IMWRITE_JPEG_QUALITY);
+        params.push_back(95);
+    }
+    if (!cv::imencode(format_ == FrameFormat::Png ? ".png" : ".jpg", image, buffer, params)) {
+        return false;
+    }
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool parseFrameFormat(const std::string &name, FrameFormat &format)
+{
+    if (name == "png") {
+        format = FrameFormat::Png;
+    } else if (name == "jpg" || name == "jpeg") {
+        format = FrameFormat::Jpeg;
+    } else if (name == "raw") {
+        format = FrameFormat::Raw;
+    } else {
+        return false;
+    }
+    return true;
+}
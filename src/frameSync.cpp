@@ -0,0 +1,134 @@
+#include "frameSync.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ClockAlignment::ClockAlignment(double window)
+    : window_(window), windowStart_(0.0),
+      current_(std::numeric_limits<double>::infinity()), previous_(std::numeric_limits<double>::infinity()),
+      offset_(0.0), valid_(false)
+{
+}
+
+void ClockAlignment::update(double stamp, double received)
+{
+    if (received - windowStart_ >= window_) {
+        previous_ = current_;
+        current_ = std::numeric_limits<double>::infinity();
+        windowStart_ = received;
+    }
+    current_ = std::min(current_, received - stamp);
+    offset_.store(std::min(current_, previous_), std::memory_order_relaxed);
+    valid_.store(true, std::memory_order_release);
+}
+
+ImuRing::ImuRing(std::size_t capacity)
+    : head_(0)
+{
+    std::size_t n = 1;
+    while (n < capacity) {
+        n <<= 1;
+    }
+    slots_.resize(n);
+    mask_ = n - 1;
+}
+
+void ImuRing::push(const ImuSample &sample)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_[head_ & mask_] = sample;
+    head_++;
+}
+
+double ImuRing::newest() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return head_ == 0 ? std::numeric_limits<double>::quiet_NaN() : slots_[(head_ - 1) & mask_].stamp;
+}
+
+std::size_t ImuRing::upperBound(std::size_t begin, std::size_t end, double t) const
+{
+    while (begin < end) {
+        std::size_t mid = begin + (end - begin) / 2;
+        if (slots_[mid & mask_].stamp <= t) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
+bool ImuRing::bracket(double stamp, ImuSample &before, ImuSample &after) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t first = oldest();
+    std::size_t i = upperBound(first, head_, stamp);
+    if (i == first || i == head_) {
+        return false;
+    }
+    before = slots_[(i - 1) & mask_];
+    after = slots_[i & mask_];
+    return true;
+}
+
+bool ImuRing::range(double from, double to, std::vector<ImuSample> &out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t first = oldest();
+    std::size_t begin = upperBound(first, head_, from);
+    // samples before from may already be overwritten
+    if (begin == first && head_ > slots_.size()) {
+        return false;
+    }
+    std::size_t end = std::min(upperBound(begin, head_, to) + 1, head_);
+    for (std::size_t i = begin; i < end; i++) {
+        out.push_back(slots_[i & mask_]);
+    }
+    return true;
+}
+
+FrameImuSync::FrameImuSync(std::size_t imuCapacity, double maxGap)
+    : imu_(imuCapacity), maxGap_(maxGap), lastFrame_(-std::numeric_limits<double>::infinity())
+{
+}
+
+void FrameImuSync::addImu(const ImuSample &sample, double received)
+{
+    clock_.update(sample.stamp, received);
+    imu_.push(sample);
+}
+
+FrameImuSync::Result FrameImuSync::pair(const FrameRef &frame, FrameImuPair &out)
+{
+    if (!clock_.valid()) {
+        return Pending;
+    }
+    double t = clock_.toDevice(frame->stamp);
+    if (!(imu_.newest() > t)) {
+        return Pending;
+    }
+
+    ImuSample before, after;
+    if (!imu_.bracket(t, before, after) || after.stamp - before.stamp > maxGap_) {
+        return Failed;
+    }
+    double w = (t - before.stamp) / (after.stamp - before.stamp);
+    out.frame = frame;
+    out.stamp = t;
+    out.imu = before;
+    out.imu.stamp = t;
+    out.imu.ax += w * (after.ax - before.ax);
+    out.imu.ay += w * (after.ay - before.ay);
+    out.imu.az += w * (after.az - before.az);
+    out.imu.wx += w * (after.wx - before.wx);
+    out.imu.wy += w * (after.wy - before.wy);
+    out.imu.wz += w * (after.wz - before.wz);
+
+    out.samples.clear();
+    if (!imu_.range(std::max(lastFrame_, t - 1.0), t, out.samples)) {
+        return Failed;
+    }
+    lastFrame_ = t;
+    return Paired;
+}
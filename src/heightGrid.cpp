@@ -0,0 +1,72 @@
+#include "heightGrid.h"
+#include <cmath>
+#include <limits>
+
+HeightGrid::HeightGrid(double minX, double minY, double maxX, double maxY, double cellSize)
+    : minX_(minX), minY_(minY), cellSize_(cellSize), invCellSize_(1.0 / cellSize),
+      sizeX_(0), sizeY_(0), points_(0), outside_(0)
+{
+    // also false for NaN, e.g. the bounds of an empty point cloud
+    if (!(cellSize > 0.0 && maxX >= minX && maxY >= minY)) {
+        return;
+    }
+    double cellsX = std::floor((maxX - minX) * invCellSize_ + 0.5) + 1.0;
+    double cellsY = std::floor((maxY - minY) * invCellSize_ + 0.5) + 1.0;
+    if (!(cellsX <= std::numeric_limits<int>::max() && cellsY <= std::numeric_limits<int>::max())) {
+        return;
+    }
+    sizeX_ = int(cellsX);
+    sizeY_ = int(cellsY);
+    std::size_t cells = std::size_t(sizeX_) * sizeY_;
+    count_.assign(cells, 0);
+    first_.assign(cells, 0.0f);
+    min_.assign(cells, 0.0f);
+    max_.assign(cells, 0.0f);
+    sum_.assign(cells, 0.0);
+    sumSq_.assign(cells, 0.0);
+}
+
+bool HeightGrid::add(double x, double y, float z)
+{
+    double fx = std::floor((x - minX_) * invCellSize_ + 0.5);
+    double fy = std::floor((y - minY_) * invCellSize_ + 0.5);
+    if (!(fx >= 0.0 && fx < sizeX_ && fy >= 0.0 && fy < sizeY_)) {
+        outside_++;
+        return false;
+    }
+    std::size_t i = index(int(fx), int(fy));
+    points_++;
+
+    if (count_[i] == 0) {
+        count_[i] = 1;
+        first_[i] = min_[i] = max_[i] = z;
+        return true;
+    }
+    count_[i]++;
+    if (z < min_[i]) {
+        min_[i] = z;
+    }
+    if (z > max_[i]) {
+        max_[i] = z;
+    }
+    double d = double(z) - first_[i];
+    sum_[i] += d;
+    sumSq_[i] += d * d;
+    return true;
+}
+
+double HeightGrid::mean(int ix, int iy) const
+{
+    std::size_t i = index(ix, iy);
+    return count_[i] == 0 ? 0.0 : first_[i] + sum_[i] / count_[i];
+}
+
+double HeightGrid::stddev(int ix, int iy) const
+{
+    std::size_t i = index(ix, iy);
+    if (count_[i] < 2) {
+        return 0.0;
+    }
+    double variance = (sumSq_[i] - sum_[i] * sum_[i] / count_[i]) / (count_[i] - 1);
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
@@ -0,0 +1,164 @@
+#include "imuKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+Eigen::ArrayXd accelerationNorm(const ImuData &data)
+{
+    return (data.ax.square() + data.ay.square() + data.az.square()).sqrt();
+}
+
+Eigen::ArrayXd gyroNorm(const ImuData &data)
+{
+    return (data.wx.square() + data.wy.square() + data.wz.square()).sqrt();
+}
+
+ImuVector estimateBias(const ImuData &data, double duration)
+{
+    Eigen::Index n = data.size();
+    if (n == 0) {
+        return ImuVector::Zero();
+    }
+    Eigen::Index end = std::upper_bound(data.t.data(), data.t.data() + n, data.t[0] + duration) - data.t.data();
+    end = std::max<Eigen::Index>(end, 1);
+
+    ImuVector bias;
+    bias << data.ax.head(end).mean(), data.ay.head(end).mean(), data.az.head(end).mean(),
+        data.wx.head(end).mean(), data.wy.head(end).mean(), data.wz.head(end).mean();
+    return bias;
+}
+
+void removeBias(ImuData &data, const ImuVector &bias)
+{
+    data.ax -= bias[IMU_AX];
+    data.ay -= bias[IMU_AY];
+    data.az -= bias[IMU_AZ];
+    data.wx -= bias[IMU_WX];
+    data.wy -= bias[IMU_WY];
+    data.wz -= bias[IMU_WZ];
+}
+
+namespace {
+
+void cumulativeSum(Eigen::ArrayXd &x)
+{
+    for (Eigen::Index i = 1; i < x.size(); i++) {
+        x[i] += x[i - 1];
+    }
+}
+
+}
+
+void integrateGyro(const ImuData &data, Eigen::ArrayXd &angleX, Eigen::ArrayXd &angleY, Eigen::ArrayXd &angleZ)
+{
+    Eigen::Index n = data.size();
+    angleX.setZero(n);
+    angleY.setZero(n);
+    angleZ.setZero(n);
+    if (n < 2) {
+        return;
+    }
+
+    // increments are computed vectorized, only the running sum is sequential
+    Eigen::ArrayXd dt = data.t.tail(n - 1) - data.t.head(n - 1);
+    angleX.tail(n - 1) = data.wx.tail(n - 1) * dt;
+    angleY.tail(n - 1) = data.wy.tail(n - 1) * dt;
+    angleZ.tail(n - 1) = data.wz.tail(n - 1) * dt;
+    cumulativeSum(angleX);
+    cumulativeSum(angleY);
+    cumulativeSum(angleZ);
+}
+
+Eigen::ArrayXd movingAverage(const Eigen::ArrayXd &x, Eigen::Index window)
+{
+    Eigen::Index n = x.size();
+    if (n == 0 || window <= 1) {
+        return x;
+    }
+    window = std::min(window, n);
+
+    // differences of a prefix sum, one subtraction per sample whatever the window
+    Eigen::ArrayXd sum(n + 1);
+    sum[0] = 0.0;
+    sum.tail(n) = x;
+    cumulativeSum(sum);
+
+    Eigen::ArrayXd y(n);
+    y.head(window) = sum.segment(1, window) / Eigen::ArrayXd::LinSpaced(window, 1.0, double(window));
+    y.tail(n - window) = (sum.tail(n - window) - sum.segment(1, n - window)) / double(window);
+    return y;
+}
+
+void movingAverage(ImuData &data, Eigen::Index window)
+{
+    Eigen::ArrayXd *channels[] = {&data.ax, &data.ay, &data.az, &data.wx, &data.wy, &data.wz};
+    for (Eigen::ArrayXd *c : channels) {
+        *c = movingAverage(*c, window);
+    }
+}
+
+void lowPass(ImuData &data, double alpha)
+{
+    Eigen::Index n = data.size();
+    if (n == 0) {
+        return;
+    }
+
+    // the recursion is sequential in time, so vectorize across the channels instead
+    ImuVector y;
+    y << data.ax[0], data.ay[0], data.az[0], data.wx[0], data.wy[0], data.wz[0];
+    for (Eigen::Index i = 1; i < n; i++) {
+        ImuVector x;
+        x << data.ax[i], data.ay[i], data.az[i], data.wx[i], data.wy[i], data.wz[i];
+        y += alpha * (x - y);
+        data.ax[i] = y[IMU_AX];
+        data.ay[i] = y[IMU_AY];
+        data.az[i] = y[IMU_AZ];
+        data.wx[i] = y[IMU_WX];
+        data.wy[i] = y[IMU_WY];
+        data.wz[i] = y[IMU_WZ];
+    }
+}
+
+bool resample(const ImuData &data, double rate, ImuData &out)
+{
+    Eigen::Index n = data.size();
+    if (!(rate > 0.0) || !std::isfinite(rate)) {
+        out = ImuData();
+        return false;
+    }
+    if (n == 0) {
+        out = ImuData();
+        return true;
+    }
+    // the output indices are ints, see below
+    double intervals = std::floor((data.t[n - 1] - data.t[0]) * rate + 1e-9);
+    if (!(intervals >= 0.0) || intervals >= double(std::numeric_limits<int>::max())) {
+        out = ImuData();
+        return false;
+    }
+    Eigen::Index m = Eigen::Index(intervals) + 1;
+    out.t = Eigen::ArrayXd::LinSpaced(m, 0.0, double(m - 1)) / rate + data.t[0];
+
+    // left neighbour and weight for every output sample, then one gather per channel
+    Eigen::ArrayXi index(m);
+    Eigen::ArrayXd weight(m);
+    Eigen::Index j = 0;
+    for (Eigen::Index i = 0; i < m; i++) {
+        while (j + 2 < n && data.t[j + 1] <= out.t[i]) {
+            j++;
+        }
+        double span = n > 1 ? data.t[j + 1] - data.t[j] : 0.0;
+        index[i] = int(j);
+        weight[i] = span > 0.0 ? std::min(std::max((out.t[i] - data.t[j]) / span, 0.0), 1.0) : 0.0;
+    }
+    Eigen::ArrayXi next = (index + 1).min(int(std::max<Eigen::Index>(n - 1, 0)));
+
+    const Eigen::ArrayXd *in[] = {&data.ax, &data.ay, &data.az, &data.wx, &data.wy, &data.wz};
+    Eigen::ArrayXd *res[] = {&out.ax, &out.ay, &out.az, &out.wx, &out.wy, &out.wz};
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        const Eigen::ArrayXd &x = *in[c];
+        *res[c] = x(index) * (1.0 - weight) + x(next) * weight;
+    }
+    return true;
+}
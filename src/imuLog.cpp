@@ -0,0 +1,219 @@
+#include "imuLog.h"
+#include "imuRecord.h"
+#include "mappedFile.h"
+#include "messageDecoder.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Chunk {
+    const char *begin;
+    const char *end;
+    Eigen::Index offset;    // first row reserved for this chunk
+    Eigen::Index lines;
+    Eigen::Index samples;
+    std::exception_ptr error;
+};
+
+Eigen::Index countLines(const char *begin, const char *end)
+{
+    Eigen::Index n = 0;
+    const char *p = begin;
+    while (p < end) {
+        const char *nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        n++;
+        if (nl == nullptr) {
+            break;
+        }
+        p = nl + 1;
+    }
+    return n;
+}
+
+void decodeChunk(Chunk &chunk, ImuData &data)
+{
+    try {
+        Message msg;
+        Eigen::Index row = chunk.offset;
+        const char *p = chunk.begin;
+        while (p < chunk.end) {
+            const char *nl = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+            const char *lineEnd = nl != nullptr ? nl : chunk.end;
+            const char *q = p;
+            while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r')) {
+                ++q;
+            }
+            if (q < lineEnd && decodeMessage(p, lineEnd, msg) == MessageType::ImuRaw) {
+                data.t[row] = msg.imu.stamp;
+                data.ax[row] = msg.imu.ax;
+                data.ay[row] = msg.imu.ay;
+                data.az[row] = msg.imu.az;
+                data.wx[row] = msg.imu.wx;
+                data.wy[row] = msg.imu.wy;
+                data.wz[row] = msg.imu.wz;
+                row++;
+            }
+            p = lineEnd + 1;
+        }
+        chunk.samples = row - chunk.offset;
+    } catch (...) {
+        chunk.error = std::current_exception();
+    }
+}
+
+template<typename F>
+void forEachChunk(std::vector<Chunk> &chunks, F f)
+{
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < chunks.size(); i++) {
+        workers.push_back(std::thread(f, std::ref(chunks[i])));
+    }
+    f(chunks[0]);
+    for (std::thread &t : workers) {
+        t.join();
+    }
+}
+
+}
+
+bool loadIMU(const std::string &path, ImuData &data, unsigned int threads)
+{
+    if (ImuRecordReader::isRecording(path)) {
+        ImuRecordReader record;
+        if (!record.open(path)) {
+            return false;
+        }
+        record.read(data);
+        return true;
+    }
+
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // split into newline aligned chunks
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+    std::vector<Chunk> chunks;
+    std::size_t step = file.size() / threads + 1;
+    const char *p = begin;
+    while (p < end || chunks.empty()) {
+        const char *q = p + std::min<std::size_t>(step, end - p);
+        if (q < end) {
+            const char *nl = static_cast<const char*>(std::memchr(q, '\n', end - q));
+            q = nl != nullptr ? nl + 1 : end;
+        }
+        Chunk c = {p, q, 0, 0, 0, nullptr};
+        chunks.push_back(c);
+        p = q;
+    }
+
+    // reserve one row per line, then decode every chunk into its own rows
+    forEachChunk(chunks, [](Chunk &c) { c.lines = countLines(c.begin, c.end); });
+
+    Eigen::Index rows = 0;
+    for (Chunk &c : chunks) {
+        c.offset = rows;
+        rows += c.lines;
+    }
+    data.t.resize(rows);
+    data.ax.resize(rows);
+    data.ay.resize(rows);
+    data.az.resize(rows);
+    data.wx.resize(rows);
+    data.wy.resize(rows);
+    data.wz.resize(rows);
+
+    forEachChunk(chunks, [&data](Chunk &c) { decodeChunk(c, data); });
+
+    for (Chunk &c : chunks) {
+        if (c.error) {
+            std::rethrow_exception(c.error);
+        }
+    }
+
+    // close the gaps left by non-IMU lines, a no-op for pure IMU logs
+    Eigen::Index n = 0;
+    for (const Chunk &c : chunks) {
+        if (c.offset != n && c.samples > 0) {
+            Eigen::ArrayXd *columns[] = {&data.t, &data.ax, &data.ay, &data.az, &data.wx, &data.wy, &data.wz};
+            for (Eigen::ArrayXd *col : columns) {
+                std::memmove(col->data() + n, col->data() + c.offset, c.samples * sizeof(double));
+            }
+        }
+        n += c.samples;
+    }
+    if (n != rows) {
+        data.t.conservativeResize(n);
+        data.ax.conservativeResize(n);
+        data.ay.conservativeResize(n);
+        data.az.conservativeResize(n);
+        data.wx.conservativeResize(n);
+        data.wy.conservativeResize(n);
+        data.wz.conservativeResize(n);
+    }
+
+    return true;
+}
+
+bool streamIMU(const std::string &path, const std::function<void(const ImuSample &)> &callback)
+{
+    ImuSample sample;
+    if (ImuRecordReader::isRecording(path)) {
+        ImuRecordReader record;
+        if (!record.open(path)) {
+            return false;
+        }
+        double channels[RECORD_CHANNELS];
+        for (std::size_t i = 0; i < record.blockCount(); i++) {
+            const ImuRecordBlock &b = record.block(i);
+            for (Eigen::Index j = 0; j < b.count; j++) {
+                for (int c = 0; c < RECORD_CHANNELS; c++) {
+                    channels[c] = b.isFloat(c) ? static_cast<const float*>(b.channels[c])[j]
+                        : static_cast<const double*>(b.channels[c])[j];
+                }
+                sample.stamp = b.t[j];
+                sample.seq = b.seq[j];
+                sample.ax = channels[0];
+                sample.ay = channels[1];
+                sample.az = channels[2];
+                sample.wx = channels[3];
+                sample.wy = channels[4];
+                sample.wz = channels[5];
+                callback(sample);
+            }
+        }
+        return true;
+    }
+
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    Message msg;
+    const char *p = file.data();
+    const char *end = p + file.size();
+    while (p < end) {
+        const char *nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char *lineEnd = nl != nullptr ? nl : end;
+        const char *q = p;
+        while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r')) {
+            ++q;
+        }
+        if (q < lineEnd && decodeMessage(p, lineEnd, msg) == MessageType::ImuRaw) {
+            callback(msg.imu);
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
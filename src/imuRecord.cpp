@@ -0,0 +1,349 @@
+#include "imuRecord.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+inline uint64_t padded(uint64_t bytes)
+{
+    return (bytes + 7) & ~uint64_t(7);
+}
+
+uint64_t channelBytes(uint32_t count, bool isFloat)
+{
+    return isFloat ? padded(uint64_t(count) * sizeof(float)) : uint64_t(count) * sizeof(double);
+}
+
+// finite and in arrival order, tells samples apart from e.g. a cut off index
+bool plausibleStamps(const ImuRecordBlock &block)
+{
+    for (Eigen::Index i = 0; i < block.count; i++) {
+        if (!std::isfinite(block.t[i]) || (i > 0 && block.t[i] < block.t[i - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+ImuRecordWriter::ImuRecordWriter(uint32_t blockCapacity)
+    : file_(nullptr), offset_(0), capacity_(blockCapacity), count_(0),
+      t_(blockCapacity), seq_(blockCapacity), floats_(blockCapacity + 1)
+{
+    for (int c = 0; c < RECORD_CHANNELS; c++) {
+        channels_[c].resize(blockCapacity);
+    }
+}
+
+ImuRecordWriter::~ImuRecordWriter()
+{
+    close();
+}
+
+bool ImuRecordWriter::open(const std::string &path)
+{
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        return false;
+    }
+
+    RecordHeader header;
+    std::memcpy(header.magic, RECORD_MAGIC, sizeof(header.magic));
+    header.version = RECORD_VERSION;
+    header.blockCapacity = capacity_;
+    std::fwrite(&header, sizeof(header), 1, file_);
+    offset_ = sizeof(header);
+    count_ = 0;
+    index_.clear();
+    return true;
+}
+
+void ImuRecordWriter::write(const ImuSample &sample)
+{
+    t_[count_] = sample.stamp;
+    seq_[count_] = sample.seq;
+    channels_[0][count_] = sample.ax;
+    channels_[1][count_] = sample.ay;
+    channels_[2][count_] = sample.az;
+    channels_[3][count_] = sample.wx;
+    channels_[4][count_] = sample.wy;
+    channels_[5][count_] = sample.wz;
+    if (++count_ == capacity_) {
+        flushBlock();
+    }
+}
+
+void ImuRecordWriter::flushBlock()
+{
+    if (count_ == 0) {
+        return;
+    }
+
+    RecordBlockHeader header;
+    header.magic = RECORD_BLOCK_MAGIC;
+    header.count = count_;
+    header.flags = RECORD_FLOAT_ACC | RECORD_FLOAT_GYRO;
+    header.reserved = 0;
+    for (int c = 0; c < RECORD_CHANNELS; c++) {
+        for (uint32_t i = 0; i < count_; i++) {
+            if (double(float(channels_[c][i])) != channels_[c][i]) {
+                header.flags &= ~recordFloatFlag(c);
+                break;
+            }
+        }
+    }
+
+    std::fwrite(&header, sizeof(header), 1, file_);
+    std::fwrite(t_.data(), sizeof(double), count_, file_);
+    std::fwrite(seq_.data(), sizeof(uint64_t), count_, file_);
+    for (int c = 0; c < RECORD_CHANNELS; c++) {
+        bool isFloat = (header.flags & recordFloatFlag(c)) != 0;
+        if (isFloat) {
+            for (uint32_t i = 0; i < count_; i++) {
+                floats_[i] = float(channels_[c][i]);
+            }
+            // pad to 8 bytes
+            floats_[count_] = 0.0f;
+            std::fwrite(floats_.data(), 1, channelBytes(count_, true), file_);
+        } else {
+            std::fwrite(channels_[c].data(), sizeof(double), count_, file_);
+        }
+    }
+
+    RecordIndexEntry entry;
+    entry.offset = offset_;
+    entry.count = count_;
+    entry.tMin = *std::min_element(t_.begin(), t_.begin() + count_);
+    entry.tMax = *std::max_element(t_.begin(), t_.begin() + count_);
+    entry.seqMin = *std::min_element(seq_.begin(), seq_.begin() + count_);
+    entry.seqMax = *std::max_element(seq_.begin(), seq_.begin() + count_);
+    index_.push_back(entry);
+
+    offset_ += sizeof(header) + 2 * sizeof(double) * uint64_t(count_);
+    for (int c = 0; c < RECORD_CHANNELS; c++) {
+        offset_ += channelBytes(count_, (header.flags & recordFloatFlag(c)) != 0);
+    }
+    count_ = 0;
+}
+
+void ImuRecordWriter::close()
+{
+    if (file_ == nullptr) {
+        return;
+    }
+
+    flushBlock();
+
+    RecordFooter footer;
+    footer.indexOffset = offset_;
+    footer.blockCount = index_.size();
+    std::memcpy(footer.magic, RECORD_MAGIC, sizeof(footer.magic));
+    std::fwrite(index_.data(), sizeof(RecordIndexEntry), index_.size(), file_);
+    std::fwrite(&footer, sizeof(footer), 1, file_);
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void ImuRecordBlock::read(int channel, double *out) const
+{
+    if (isFloat(channel)) {
+        const float *in = static_cast<const float*>(channels[channel]);
+        for (Eigen::Index i = 0; i < count; i++) {
+            out[i] = in[i];
+        }
+    } else {
+        std::memcpy(out, channels[channel], count * sizeof(double));
+    }
+}
+
+bool ImuRecordReader::parseBlock(uint64_t offset, ImuRecordBlock &block, uint64_t &next) const
+{
+    if (offset + sizeof(RecordBlockHeader) > file_.size()) {
+        return false;
+    }
+    RecordBlockHeader header;
+    std::memcpy(&header, file_.data() + offset, sizeof(header));
+    if (header.magic != RECORD_BLOCK_MAGIC || header.count == 0 || header.count > capacity_) {
+        return false;
+    }
+
+    uint64_t length = sizeof(header) + 2 * sizeof(double) * uint64_t(header.count);
+    for (int c = 0; c < RECORD_CHANNELS; c++) {
+        length += channelBytes(header.count, (header.flags & recordFloatFlag(c)) != 0);
+    }
+    if (offset + length > file_.size()) {
+        return false;
+    }
+
+    const char *p = file_.data() + offset + sizeof(header);
+    block.count = header.count;
+    block.flags = header.flags;
+    block.t = reinterpret_cast<const double*>(p);
+    p += sizeof(double) * header.count;
+    block.seq = reinterpret_cast<const uint64_t*>(p);
+    p += sizeof(uint64_t) * header.count;
+    for (int c = 0; c < RECORD_CHANNELS; c++) {
+        block.channels[c] = p;
+        p += channelBytes(header.count, (header.flags & recordFloatFlag(c)) != 0);
+    }
+    next = offset + length;
+    return true;
+}
+
+bool ImuRecordReader::open(const std::string &path)
+{
+    blocks_.clear();
+    size_ = 0;
+    ordered_ = true;
+    if (!file_.open(path) || file_.size() < sizeof(RecordHeader)
+        || std::memcmp(file_.data(), RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0) {
+        file_.close();
+        return false;
+    }
+    RecordHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (header.version != RECORD_VERSION || header.blockCapacity == 0) {
+        file_.close();
+        return false;
+    }
+    capacity_ = header.blockCapacity;
+
+    ImuRecordBlock block;
+    uint64_t next;
+
+    RecordFooter footer;
+    bool indexed = false;
+    if (file_.size() >= sizeof(RecordHeader) + sizeof(RecordFooter)) {
+        std::memcpy(&footer, file_.data() + file_.size() - sizeof(footer), sizeof(footer));
+        indexed = std::memcmp(footer.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC)) == 0
+            && footer.indexOffset + footer.blockCount * sizeof(RecordIndexEntry) + sizeof(footer) == file_.size();
+    }
+
+    if (indexed) {
+        const char *p = file_.data() + footer.indexOffset;
+        for (uint64_t i = 0; i < footer.blockCount; i++) {
+            RecordIndexEntry entry;
+            std::memcpy(&entry, p + i * sizeof(entry), sizeof(entry));
+            if (!parseBlock(entry.offset, block, next)) {
+                break;
+            }
+            block.tMin = entry.tMin;
+            block.tMax = entry.tMax;
+            block.seqMin = entry.seqMin;
+            block.seqMax = entry.seqMax;
+            blocks_.push_back(block);
+            size_ += block.count;
+        }
+    } else {
+        // no index, recover all complete blocks with plausible stamps
+        uint64_t offset = sizeof(RecordHeader);
+        while (parseBlock(offset, block, next) && plausibleStamps(block)) {
+            block.tMin = block.stamps().minCoeff();
+            block.tMax = block.stamps().maxCoeff();
+            block.seqMin = *std::min_element(block.seq, block.seq + block.count);
+            block.seqMax = *std::max_element(block.seq, block.seq + block.count);
+            blocks_.push_back(block);
+            size_ += block.count;
+            offset = next;
+        }
+    }
+
+    // stamps from a resynchronized clock may jump back, then blocks have to be searched linearly
+    for (std::size_t i = 1; i < blocks_.size() && ordered_; i++) {
+        ordered_ = blocks_[i].tMin >= blocks_[i - 1].tMin && blocks_[i].tMax >= blocks_[i - 1].tMax;
+    }
+    return true;
+}
+
+void ImuRecordReader::read(ImuData &data) const
+{
+    Eigen::ArrayXd *columns[] = {&data.ax, &data.ay, &data.az, &data.wx, &data.wy, &data.wz};
+    data.t.resize(size_);
+    for (Eigen::ArrayXd *col : columns) {
+        col->resize(size_);
+    }
+
+    Eigen::Index row = 0;
+    for (const ImuRecordBlock &b : blocks_) {
+        std::memcpy(data.t.data() + row, b.t, b.count * sizeof(double));
+        for (int c = 0; c < RECORD_CHANNELS; c++) {
+            b.read(c, columns[c]->data() + row);
+        }
+        row += b.count;
+    }
+}
+
+std::size_t ImuRecordReader::findBlock(double stamp) const
+{
+    if (!ordered_) {
+        std::size_t i = 0;
+        while (i < blocks_.size() && blocks_[i].tMax < stamp) {
+            i++;
+        }
+        return i;
+    }
+    std::vector<ImuRecordBlock>::const_iterator it = std::lower_bound(blocks_.begin(), blocks_.end(), stamp,
+        [](const ImuRecordBlock &b, double t) { return b.tMax < t; });
+    return it - blocks_.begin();
+}
+
+Eigen::Index ImuRecordReader::readWindow(double t0, double t1, ImuData &data) const
+{
+    // ordered blocks overlapping the window are consecutive, otherwise all are checked
+    std::size_t first = findBlock(t0);
+    std::size_t last = first;
+    Eigen::Index rows = 0;
+    while (last < blocks_.size() && (!ordered_ || blocks_[last].tMin <= t1)) {
+        if (overlaps(blocks_[last], t0, t1)) {
+            rows += blocks_[last].count;
+        }
+        last++;
+    }
+
+    Eigen::ArrayXd *columns[] = {&data.ax, &data.ay, &data.az, &data.wx, &data.wy, &data.wz};
+    data.t.resize(rows);
+    for (Eigen::ArrayXd *col : columns) {
+        col->resize(rows);
+    }
+
+    // copy whole blocks, then drop the samples outside the window
+    Eigen::Index row = 0;
+    for (std::size_t i = first; i < last; i++) {
+        const ImuRecordBlock &b = blocks_[i];
+        if (!overlaps(b, t0, t1)) {
+            continue;
+        }
+        std::memcpy(data.t.data() + row, b.t, b.count * sizeof(double));
+        for (int c = 0; c < RECORD_CHANNELS; c++) {
+            b.read(c, columns[c]->data() + row);
+        }
+        row += b.count;
+    }
+
+    Eigen::Index n = 0;
+    for (Eigen::Index i = 0; i < rows; i++) {
+        if (data.t[i] >= t0 && data.t[i] <= t1) {
+            data.t[n] = data.t[i];
+            for (Eigen::ArrayXd *col : columns) {
+                (*col)[n] = (*col)[i];
+            }
+            n++;
+        }
+    }
+    data.t.conservativeResize(n);
+    for (Eigen::ArrayXd *col : columns) {
+        col->conservativeResize(n);
+    }
+    return n;
+}
+
+bool ImuRecordReader::isRecording(const std::string &path)
+{
+    char magic[sizeof(RECORD_MAGIC)];
+    std::ifstream ifs(path, std::ifstream::in | std::ifstream::binary);
+    return ifs.read(magic, sizeof(magic)) && std::memcmp(magic, RECORD_MAGIC, sizeof(magic)) == 0;
+}
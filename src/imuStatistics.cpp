@@ -0,0 +1,80 @@
+#include "imuStatistics.h"
+#include <cmath>
+#include <limits>
+
+ImuStatistics::ImuStatistics()
+{
+    reset();
+}
+
+void ImuStatistics::reset()
+{
+    n_ = 0;
+    mean_.setZero();
+    min_.setConstant(std::numeric_limits<double>::infinity());
+    max_.setConstant(-std::numeric_limits<double>::infinity());
+    comoment_.setZero();
+}
+
+void ImuStatistics::add(const ImuSample &sample)
+{
+    add(imuVector(sample));
+}
+
+void ImuStatistics::add(const ImuVector &x)
+{
+    n_++;
+    ImuVector delta = x - mean_;
+    mean_ += delta / double(n_);
+    comoment_.noalias() += delta * (x - mean_).transpose();
+    min_ = min_.cwiseMin(x);
+    max_ = max_.cwiseMax(x);
+}
+
+void ImuStatistics::merge(const ImuStatistics &other)
+{
+    if (other.n_ == 0) {
+        return;
+    }
+    if (n_ == 0) {
+        *this = other;
+        return;
+    }
+
+    double n = double(n_ + other.n_);
+    ImuVector delta = other.mean_ - mean_;
+    comoment_ += other.comoment_ + delta * delta.transpose() * (double(n_) * double(other.n_) / n);
+    mean_ += delta * (double(other.n_) / n);
+    n_ += other.n_;
+    min_ = min_.cwiseMin(other.min_);
+    max_ = max_.cwiseMax(other.max_);
+}
+
+ImuVector ImuStatistics::variance() const
+{
+    if (n_ < 2) {
+        return ImuVector::Constant(std::numeric_limits<double>::quiet_NaN());
+    }
+    return comoment_.diagonal() / double(n_ - 1);
+}
+
+double ImuStatistics::variance(int channel) const
+{
+    if (n_ < 2) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return comoment_(channel, channel) / double(n_ - 1);
+}
+
+double ImuStatistics::stdDev(int channel) const
+{
+    return std::sqrt(variance(channel));
+}
+
+ImuMatrix ImuStatistics::covariance() const
+{
+    if (n_ < 2) {
+        return ImuMatrix::Constant(std::numeric_limits<double>::quiet_NaN());
+    }
+    return comoment_ / double(n_ - 1);
+}
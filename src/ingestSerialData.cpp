@@ -0,0 +1,136 @@
+#include <asio/signal_set.hpp>
+#include <asio/steady_timer.hpp>
+#include "ingestionEngine.h"
+#include "commandChannel.h"
+#include "messageDecoder.h"
+#include "outputSink.h"
+#include "settings.h"
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(LINUX_OS) || defined(MACOS_OS)
+#include <poll.h>
+#include <unistd.h>
+#define HAVE_STDIN_COMMANDS
+#endif
+
+
+int main(int argc, char *argv[])
+{
+    // "serial_ports": [{"port": "/dev/ttyACM0", "baudrate": 115200}, ...]
+    // falls back to the single "serial_port" / "serial_baudrate" entry
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_SERIAL)) {
+        return -1;
+    }
+
+    // subscriptions of all ports and the output, guarded as subscriptions change from stdin while lines arrive
+    std::vector<CommandChannel> commands;
+    std::mutex stateMutex;
+    OutputSink sink;
+    sink.openStdout();
+    std::ostream out(&sink);
+
+    // every line is decoded on its port's strand, the dispatch only prints it and tracks the subscriptions
+    IngestionEngine engine([&](std::size_t port, const LineView &line, const Message *msg) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        out << port << ": ";
+        out.write(line.data, line.size) << '\n';
+        if (msg != nullptr) {
+            commands[port].received(msg->name);
+        }
+    });
+
+    for (const SerialPortSettings &p : settings.serialPorts) {
+        std::cout << "Opening port " << p.port << " with baudrate " << p.baudrate << "." << std::endl;
+        std::size_t index = engine.addPort(p.port, p.baudrate);
+        commands.push_back(CommandChannel([&engine, index](const std::string &command) { engine.write(index, command); }));
+    }
+
+    // ingestSerialData [<message type> ...] subscribes at startup, every line on stdin
+    // replaces the subscriptions of all ports with the message types it lists
+    std::function<void(const std::vector<std::string> &)> subscribe = [&](const std::vector<std::string> &types) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        for (CommandChannel &c : commands) {
+            c.setSubscriptions(types);
+            c.flush();
+        }
+    };
+    if (argc > 1) {
+        subscribe(std::vector<std::string>(argv + 1, argv + argc));
+    }
+
+    // stdin is polled, so the thread notices the shutdown and is joined before the state it uses goes away
+    std::atomic<bool> stopping(false);
+    std::thread input([&]() {
+#ifdef HAVE_STDIN_COMMANDS
+        LineBuffer buffer(1024);
+        while (!stopping) {
+            struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+            if (poll(&pfd, 1, 100) <= 0) {
+                continue;
+            }
+            std::size_t size;
+            char *data = buffer.prepare(size);
+            ssize_t n = ::read(STDIN_FILENO, data, size);
+            if (n <= 0) {
+                break;
+            }
+            buffer.commit(std::size_t(n));
+
+            LineView line;
+            while (buffer.nextLine(line)) {
+                std::istringstream words(line.str());
+                std::vector<std::string> types;
+                std::string type;
+                while (words >> type) {
+                    types.push_back(type);
+                }
+                subscribe(types);
+            }
+        }
+#endif
+    });
+
+    asio::steady_timer timer(engine.context());
+    std::function<void(const asio::error_code &)> tick = [&](const asio::error_code &ec) {
+        if (ec) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            sink.tick();
+            for (std::size_t i = 0; i < commands.size(); i++) {
+                bool wasPending = commands[i].pending();
+                commands[i].tick();
+                if (wasPending && commands[i].failed()) {
+                    std::cerr << "Warning: Port " << i << " did not switch to the requested messages!" << std::endl;
+                }
+            }
+        }
+        timer.expires_after(std::chrono::milliseconds(100));
+        timer.async_wait(tick);
+    };
+    tick(asio::error_code());
+
+    asio::signal_set signals(engine.context(), SIGINT);
+    signals.async_wait([&engine](const asio::error_code &, int) { engine.stop(); });
+
+    engine.run(settings.ingestionThreads);
+
+    stopping = true;
+    input.join();
+    sink.flush();
+    if (engine.undecodable() > 0) {
+        std::cerr << "Warning: " << engine.undecodable() << " lines could not be decoded!" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "ingestionEngine.h"
+#include <asio/bind_executor.hpp>
+#include <asio/error.hpp>
+#include <asio/post.hpp>
+#include <asio/write.hpp>
+#include <iostream>
+#include <thread>
+
+IngestionEngine::Port::Port(asio::io_context &ctx, std::size_t bufferSize)
+    : port(ctx), strand(ctx.get_executor()), buffer(bufferSize), synced(false)
+{
+}
+
+IngestionEngine::IngestionEngine(Handler handler, std::size_t bufferSize)
+    : handler_(handler), undecodable_(0), openPorts_(0), bufferSize_(bufferSize)
+{
+}
+
+IngestionEngine::IngestionEngine(MessageHandler handler, std::size_t bufferSize)
+    : messageHandler_(handler), undecodable_(0), openPorts_(0), bufferSize_(bufferSize)
+{
+}
+
+std::size_t IngestionEngine::addPort(const std::string &device, int baudrate)
+{
+    std::unique_ptr<Port> p(new Port(ctx_, bufferSize_));
+    p->device = device;
+    p->port.open(device);
+    p->port.set_option(asio::serial_port::baud_rate(baudrate));
+    p->port.set_option(asio::serial_port::flow_control(asio::serial_port::flow_control::none));
+    p->port.set_option(asio::serial_port::character_size(8));
+    p->port.set_option(asio::serial_port::parity(asio::serial_port::parity::none));
+    p->port.set_option(asio::serial_port::stop_bits(asio::serial_port::stop_bits::one));
+    ports_.push_back(std::move(p));
+    return ports_.size() - 1;
+}
+
+void IngestionEngine::run(unsigned int threads)
+{
+    openPorts_ = ports_.size();
+    for (std::size_t i = 0; i < ports_.size(); i++) {
+        startRead(i);
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; i++) {
+        workers.push_back(std::thread([this]() { ctx_.run(); }));
+    }
+    ctx_.run();
+    for (std::thread &t : workers) {
+        t.join();
+    }
+}
+
+void IngestionEngine::stop()
+{
+    ctx_.stop();
+}
+
+void IngestionEngine::startRead(std::size_t index)
+{
+    Port &p = *ports_[index];
+    std::size_t size;
+    char *data = p.buffer.prepare(size);
+    p.port.async_read_some(asio::buffer(data, size), asio::bind_executor(p.strand,
+        [this, index](const asio::error_code &ec, std::size_t n) { handleRead(index, ec, n); }));
+}
+
+void IngestionEngine::handleRead(std::size_t index, const asio::error_code &ec, std::size_t size)
+{
+    Port &p = *ports_[index];
+    if (ec) {
+        if (ec != asio::error::operation_aborted) {
+            std::cerr << "Error: Failed reading from serial port " << p.device << ": " << ec.message() << std::endl;
+            // timers and other work of the caller would keep run() going without anything left to read
+            if (--openPorts_ == 0) {
+                ctx_.stop();
+            }
+        }
+        return;
+    }
+
+    p.buffer.commit(size);
+
+    LineView line;
+    while (p.buffer.nextLine(line)) {
+        // the first line after opening the port may be incomplete
+        if (!p.synced) {
+            p.synced = true;
+            continue;
+        }
+        if (handler_) {
+            std::lock_guard<std::mutex> lock(dispatchMutex_);
+            handler_(index, line);
+            continue;
+        }
+
+        // decoded before the dispatch lock, so the ports are decoded in parallel
+        const Message *msg = &p.msg;
+        try {
+            decodeMessage(line.begin(), line.end(), p.msg);
+        } catch (...) {
+            undecodable_.fetch_add(1, std::memory_order_relaxed);
+            msg = nullptr;
+        }
+        std::lock_guard<std::mutex> lock(dispatchMutex_);
+        messageHandler_(index, line, msg);
+    }
+
+    startRead(index);
+}
+
+void IngestionEngine::write(std::size_t index, const std::string &data)
+{
+    asio::post(ports_[index]->strand, [this, index, data]() {
+        Port &p = *ports_[index];
+        p.writes.push_back(data);
+        // one write at a time, the others wait in the queue
+        if (p.writes.size() == 1) {
+            startWrite(index);
+        }
+    });
+}
+
+void IngestionEngine::startWrite(std::size_t index)
+{
+    Port &p = *ports_[index];
+    asio::async_write(p.port, asio::buffer(p.writes.front()), asio::bind_executor(p.strand,
+        [this, index](const asio::error_code &ec, std::size_t) {
+            Port &p = *ports_[index];
+            if (ec) {
+                if (ec != asio::error::operation_aborted) {
+                    std::cerr << "Error: Failed writing to serial port " << p.device << ": " << ec.message() << std::endl;
+                }
+                p.writes.clear();
+                return;
+            }
+            p.writes.pop_front();
+            if (!p.writes.empty()) {
+                startWrite(index);
+            }
+        }));
+}
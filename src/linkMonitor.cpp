@@ -0,0 +1,154 @@
+#include "linkMonitor.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace {
+
+const int SUB_BUCKET_BITS = 6;
+const uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+const int MAX_BITS = 40;
+const std::size_t BUCKETS = std::size_t(SUB_BUCKETS * (MAX_BITS - SUB_BUCKET_BITS + 2));
+
+int highestBit(uint64_t v)
+{
+    int bit = 0;
+    while (v >>= 1) {
+        bit++;
+    }
+    return bit;
+}
+
+std::size_t bucketIndex(uint64_t v)
+{
+    if (v < 2 * SUB_BUCKETS) {
+        return std::size_t(v);
+    }
+    int shift = std::min(highestBit(v), MAX_BITS) - SUB_BUCKET_BITS;
+    uint64_t sub = std::min<uint64_t>(v >> shift, 2 * SUB_BUCKETS - 1);
+    return std::size_t(SUB_BUCKETS * shift + sub);
+}
+
+// upper end of the values counted in a bucket
+uint64_t bucketValue(std::size_t index)
+{
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+    int shift = int(index / SUB_BUCKETS) - 1;
+    uint64_t sub = index - SUB_BUCKETS * shift;
+    return ((sub + 1) << shift) - 1;
+}
+
+uint64_t toMicroseconds(double s)
+{
+    return s > 0.0 ? uint64_t(s * 1e6 + 0.5) : 0;
+}
+
+}
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(BUCKETS)
+{
+    reset();
+}
+
+void LatencyHistogram::record(uint64_t us)
+{
+    counts_[bucketIndex(us)]++;
+    count_++;
+    sum_ += us;
+    min_ = std::min(min_, us);
+    max_ = std::max(max_, us);
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+    sum_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(uint64_t(std::ceil(q * double(count_))), 1);
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); i++) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return std::min(std::max(bucketValue(i), min_), max_);
+        }
+    }
+    return max_;
+}
+
+HeartbeatMonitor::HeartbeatMonitor()
+    : started_(false), lastSeq_(0), lastStamp_(0.0), lastReceived_(0.0),
+      offset_(std::numeric_limits<double>::quiet_NaN()), periodOffset_(std::numeric_limits<double>::infinity()),
+      received_(0), missing_(0), reordered_(0), totalReceived_(0), totalMissing_(0)
+{
+}
+
+void HeartbeatMonitor::update(const Heartbeat &heartbeat, double received)
+{
+    double offset = received - heartbeat.stamp;
+    periodOffset_ = std::min(periodOffset_, offset);
+    // until a full period has passed, the smallest offset so far has to do
+    double reference = std::isnan(offset_) ? periodOffset_ : offset_;
+    latency_.record(toMicroseconds(offset - reference));
+    received_++;
+
+    if (started_) {
+        if (heartbeat.seq > lastSeq_) {
+            missing_ += heartbeat.seq - lastSeq_ - 1;
+            jitter_.record(toMicroseconds(std::fabs((received - lastReceived_) - (heartbeat.stamp - lastStamp_))));
+        } else {
+            reordered_++;
+        }
+    }
+    if (!started_ || heartbeat.seq > lastSeq_) {
+        started_ = true;
+        lastSeq_ = heartbeat.seq;
+        lastStamp_ = heartbeat.stamp;
+        lastReceived_ = received;
+    }
+}
+
+void HeartbeatMonitor::report(std::ostream &out, double now)
+{
+    totalReceived_ += received_;
+    totalMissing_ += missing_;
+
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::setiosflags(std::ios_base::fixed) << std::setprecision(6)
+        << "{\"msg\":\"link_stats\",\"stamp\":" << now
+        << ",\"received\":" << received_ << ",\"missing\":" << missing_ << ",\"reordered\":" << reordered_
+        << ",\"total_received\":" << totalReceived_ << ",\"total_missing\":" << totalMissing_;
+    if (received_ > 0) {
+        out << ",\"offset\":" << periodOffset_;
+    }
+    out << ",\"jitter_us\":{\"p50\":" << jitter_.percentile(0.5) << ",\"p99\":" << jitter_.percentile(0.99)
+        << ",\"max\":" << jitter_.max() << "}"
+        << ",\"latency_us\":{\"p50\":" << latency_.percentile(0.5) << ",\"p90\":" << latency_.percentile(0.9)
+        << ",\"p99\":" << latency_.percentile(0.99) << ",\"p999\":" << latency_.percentile(0.999)
+        << ",\"max\":" << latency_.max() << "}}\n";
+    out.flags(flags);
+    out.precision(precision);
+
+    if (received_ > 0) {
+        offset_ = periodOffset_;
+    }
+    periodOffset_ = std::numeric_limits<double>::infinity();
+    received_ = 0;
+    missing_ = 0;
+    reordered_ = 0;
+    jitter_.reset();
+    latency_.reset();
+}
@@ -0,0 +1,116 @@
+#include "logReplay.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+LogReplay::LogReplay()
+    : recording_(false), pos_(nullptr), block_(0), sample_(0)
+{
+}
+
+bool LogReplay::open(const std::string &path)
+{
+    recording_ = ImuRecordReader::isRecording(path);
+    bool ok = recording_ ? record_.open(path) : file_.open(path);
+    rewind();
+    return ok;
+}
+
+void LogReplay::rewind()
+{
+    pos_ = file_.data();
+    block_ = 0;
+    sample_ = 0;
+}
+
+bool LogReplay::next(LineView &line, double &stamp)
+{
+    if (recording_) {
+        while (block_ < record_.blockCount() && sample_ >= record_.block(block_).count) {
+            block_++;
+            sample_ = 0;
+        }
+        if (block_ >= record_.blockCount()) {
+            return false;
+        }
+
+        const ImuRecordBlock &b = record_.block(block_);
+        double channels[RECORD_CHANNELS];
+        for (int c = 0; c < RECORD_CHANNELS; c++) {
+            channels[c] = b.isFloat(c) ? static_cast<const float*>(b.channels[c])[sample_]
+                : static_cast<const double*>(b.channels[c])[sample_];
+        }
+        stamp = b.t[sample_];
+        int n = std::snprintf(line_, sizeof(line_),
+            "{\"msg\": \"imu_raw\", \"stamp\": %.17g, \"seq\": %llu, \"wx\": %.17g, \"wy\": %.17g, \"wz\": %.17g, \"ax\": %.17g, \"ay\": %.17g, \"az\": %.17g}",
+            stamp, (unsigned long long)b.seq[sample_], channels[3], channels[4], channels[5], channels[0], channels[1], channels[2]);
+        sample_++;
+        line.data = line_;
+        line.size = std::size_t(n);
+        return true;
+    }
+
+    const char *end = file_.data() + file_.size();
+    while (pos_ != nullptr && pos_ < end) {
+        const char *nl = static_cast<const char*>(std::memchr(pos_, '\n', end - pos_));
+        const char *lineEnd = nl != nullptr ? nl : end;
+        const char *begin = pos_;
+        pos_ = lineEnd + 1;
+        if (lineEnd > begin && lineEnd[-1] == '\r') {
+            lineEnd--;
+        }
+        if (lineEnd == begin) {
+            continue;
+        }
+
+        stamp = std::numeric_limits<double>::quiet_NaN();
+        try {
+            decodeMessage(begin, lineEnd, msg_);
+            stamp = msg_.stamp;
+        } catch (...) {
+            // replay malformed lines unchanged, the consumer has to cope with them too
+        }
+        line.data = begin;
+        line.size = std::size_t(lineEnd - begin);
+        return true;
+    }
+    return false;
+}
+
+ReplayClock::ReplayClock(double speed)
+    : speed_(speed)
+{
+    reset();
+}
+
+void ReplayClock::reset()
+{
+    started_ = false;
+    firstStamp_ = 0.0;
+    lag_ = 0.0;
+}
+
+void ReplayClock::wait(double stamp)
+{
+    if (speed_ <= 0.0 || std::isnan(stamp)) {
+        return;
+    }
+    if (!started_) {
+        started_ = true;
+        firstStamp_ = stamp;
+        start_ = std::chrono::steady_clock::now();
+        return;
+    }
+
+    std::chrono::steady_clock::time_point due = start_
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((stamp - firstStamp_) / speed_));
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (due > now) {
+        std::this_thread::sleep_until(due);
+        lag_ = 0.0;
+    } else {
+        lag_ = std::chrono::duration<double>(now - due).count();
+    }
+}
@@ -0,0 +1,74 @@
+#include "mappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#if defined(LINUX_OS) || defined(MACOS_OS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAVE_MMAP
+#endif
+
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), open_(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+#ifdef HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+        void *p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            return false;
+        }
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);
+#else
+    std::ifstream ifs(path, std::ifstream::in | std::ifstream::binary);
+    if (!ifs.is_open()) {
+        return false;
+    }
+    fallback_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    size_ = fallback_.size();
+    data_ = size_ > 0 ? fallback_.data() : nullptr;
+#endif
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef HAVE_MMAP
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#else
+    fallback_.clear();
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
@@ -0,0 +1,99 @@
+#include "mappedFile.h"
+#include "messageDecoder.h"
+#include "outputSink.h"
+#include "streamMerger.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+
+struct LogCursor {
+    const char *p;
+    const char *end;
+    double stamp;   // last stamp, lines without one keep their place behind it
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc <= 2) {
+        std::cout << "Output file and at least one input file required!" << std::endl;
+        std::cout << "Usage: mergeLogs <output file (appended) | -> <input file> [<input file> ...]" << std::endl;
+        return -1;
+    }
+
+    std::size_t sources = argc - 2;
+    std::vector<MappedFile> files(sources);
+    std::vector<LogCursor> cursors(sources);
+    for (std::size_t i = 0; i < sources; i++) {
+        if (!files[i].open(argv[i + 2])) {
+            std::cerr << "Error: Unable to open " << argv[i + 2] << "!" << std::endl;
+            return -1;
+        }
+        cursors[i].p = files[i].data();
+        cursors[i].end = files[i].data() + files[i].size();
+        cursors[i].stamp = -std::numeric_limits<double>::infinity();
+    }
+
+    OutputSink sink;
+    if (std::strcmp(argv[1], "-") == 0) {
+        sink.openStdout();
+    } else if (!sink.openFile(argv[1])) {
+        std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+        return -1;
+    }
+
+    // lines are views into the mapped files, only the stamps are decoded
+    StreamMerger<LineView> merger(sources, 1024);
+    Message msg;
+    unsigned long lines = 0, failed = 0;
+    std::size_t open = sources;
+    while (open > 0 || !merger.empty()) {
+        for (std::size_t i = 0; i < sources; i++) {
+            LogCursor &c = cursors[i];
+            LineView *slot;
+            while (c.p < c.end && (slot = merger.beginPush(i)) != nullptr) {
+                const char *nl = static_cast<const char*>(std::memchr(c.p, '\n', c.end - c.p));
+                const char *lineEnd = nl != nullptr ? nl : c.end;
+                if (lineEnd > c.p) {
+                    try {
+                        decodeMessage(c.p, lineEnd, msg);
+                        if (!std::isnan(msg.stamp)) {
+                            c.stamp = msg.stamp;
+                        }
+                    } catch (...) {
+                        failed++;
+                    }
+                    slot->data = c.p;
+                    slot->size = lineEnd - c.p;
+                    merger.commitPush(i, c.stamp);
+                }
+                c.p = lineEnd + 1;
+            }
+            if (c.p >= c.end && merger.isOpen(i)) {
+                merger.close(i);
+                open--;
+            }
+        }
+
+        const LineView *line;
+        while ((line = merger.front()) != nullptr) {
+            sink.writeLine(*line);
+            merger.pop();
+            lines++;
+        }
+    }
+    sink.flush();
+
+    std::cerr << "Merged " << lines << " lines from " << sources << " files";
+    if (failed > 0) {
+        std::cerr << ", " << failed << " lines could not be parsed";
+    }
+    if (merger.late() > 0) {
+        std::cerr << ", " << merger.late() << " lines out of order";
+    }
+    std::cerr << "." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,394 @@
+#include "messageDecoder.h"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace {
+
+enum Field {
+    F_STAMP, F_SEQ, F_AX, F_AY, F_AZ, F_WX, F_WY, F_WZ, F_PRESSURE, F_COUNT, F_UNKNOWN = F_COUNT
+};
+
+const unsigned int IMU_FIELDS = (1u << F_STAMP) | (1u << F_AX) | (1u << F_AY) | (1u << F_AZ)
+    | (1u << F_WX) | (1u << F_WY) | (1u << F_WZ);
+const unsigned int HEARTBEAT_FIELDS = (1u << F_STAMP) | (1u << F_SEQ);
+const unsigned int PRESSURE_FIELDS = (1u << F_STAMP) | (1u << F_PRESSURE);
+const unsigned int INTEGER_FIELDS = (1u << F_SEQ) | (1u << F_PRESSURE);
+
+const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool equals(const char *s, std::size_t n, const char *lit)
+{
+    return std::strlen(lit) == n && std::memcmp(s, lit, n) == 0;
+}
+
+Field fieldOf(const char *s, std::size_t n)
+{
+    switch (n) {
+    case 2:
+        if (s[0] == 'a') {
+            if (s[1] == 'x') return F_AX;
+            if (s[1] == 'y') return F_AY;
+            if (s[1] == 'z') return F_AZ;
+        } else if (s[0] == 'w') {
+            if (s[1] == 'x') return F_WX;
+            if (s[1] == 'y') return F_WY;
+            if (s[1] == 'z') return F_WZ;
+        }
+        break;
+    case 3:
+        if (equals(s, n, "seq")) return F_SEQ;
+        break;
+    case 5:
+        if (equals(s, n, "stamp")) return F_STAMP;
+        break;
+    case 8:
+        if (equals(s, n, "pressure")) return F_PRESSURE;
+        break;
+    }
+    return F_UNKNOWN;
+}
+
+void setName(Message &msg, const char *s, std::size_t n)
+{
+    n = n < MESSAGE_NAME_CAPACITY ? n : MESSAGE_NAME_CAPACITY - 1;
+    std::memcpy(msg.name, s, n);
+    msg.name[n] = '\0';
+}
+
+MessageType typeOf(const char *s, std::size_t n)
+{
+    if (equals(s, n, "imu_raw")) return MessageType::ImuRaw;
+    if (equals(s, n, "heartbeat")) return MessageType::Heartbeat;
+    if (equals(s, n, "pressure_raw")) return MessageType::PressureRaw;
+    return MessageType::Other;
+}
+
+inline void skipWhitespace(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        ++p;
+    }
+}
+
+// string without escape sequences, p points to the opening quote
+bool parseString(const char *&p, const char *end, const char *&s, std::size_t &n)
+{
+    const char *q = ++p;
+    while (q < end && *q != '"') {
+        if (*q == '\\') {
+            return false;
+        }
+        ++q;
+    }
+    if (q == end) {
+        return false;
+    }
+    s = p;
+    n = q - p;
+    p = q + 1;
+    return true;
+}
+
+// exact for up to 15 significant digits and |exponent| <= 22, otherwise strtod on a local copy.
+// integer is set to the exact value of plain non-negative integers that fit, like nlohmann's
+// number_unsigned, isInteger is false for all other numbers.
+bool parseNumber(const char *&p, const char *end, double &value, uint64_t &integer, bool &isInteger)
+{
+    const char *start = p;
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    const char *intStart = p;
+    const uint64_t maxInteger = std::numeric_limits<uint64_t>::max();
+    isInteger = !negative;
+    integer = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        unsigned int d = *p - '0';
+        if (digits < 19) {
+            mantissa = mantissa * 10 + d;
+            if (mantissa != 0) digits++;
+        } else {
+            exponent++;
+        }
+        if (isInteger && integer > (maxInteger - d) / 10) {
+            isInteger = false;
+        }
+        integer = integer * 10 + d;
+        ++p;
+    }
+    if (p == intStart) {
+        return false;
+    }
+    // JSON has no leading zeros
+    if (*intStart == '0' && p - intStart > 1) {
+        return false;
+    }
+    if (p < end && *p == '.') {
+        isInteger = false;
+        ++p;
+        const char *fracStart = p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+            ++p;
+        }
+        if (p == fracStart) {
+            return false;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        isInteger = false;
+        ++p;
+        bool expNegative = false;
+        if (p < end && (*p == '+' || *p == '-')) {
+            expNegative = *p == '-';
+            ++p;
+        }
+        const char *expStart = p;
+        int e = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (e < 10000) e = e * 10 + (*p - '0');
+            ++p;
+        }
+        if (p == expStart) {
+            return false;
+        }
+        exponent += expNegative ? -e : e;
+    }
+
+    if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        value = double(mantissa);
+        value = exponent < 0 ? value / POW10[-exponent] : value * POW10[exponent];
+    } else {
+        char buf[64];
+        std::size_t n = p - start;
+        if (n >= sizeof(buf)) {
+            return false;
+        }
+        std::memcpy(buf, start, n);
+        buf[n] = '\0';
+        value = std::strtod(buf, nullptr);
+        // nlohmann rejects numbers beyond the double range
+        return std::isfinite(value);
+    }
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
+
+bool skipLiteral(const char *&p, const char *end, const char *lit)
+{
+    std::size_t n = std::strlen(lit);
+    if (std::size_t(end - p) < n || std::memcmp(p, lit, n) != 0) {
+        return false;
+    }
+    p += n;
+    return true;
+}
+
+bool decodeFast(const char *p, const char *end, Message &msg)
+{
+    double values[F_COUNT];
+    uint64_t integers[F_COUNT];
+    unsigned int present = 0;
+    unsigned int integral = 0;
+    const char *type = nullptr;
+    std::size_t typeLength = 0;
+
+    skipWhitespace(p, end);
+    if (p == end || *p != '{') {
+        return false;
+    }
+    ++p;
+    skipWhitespace(p, end);
+    if (p < end && *p == '}') {
+        ++p;
+    } else {
+        for (;;) {
+            const char *key;
+            std::size_t keyLength;
+            if (p == end || *p != '"' || !parseString(p, end, key, keyLength)) {
+                return false;
+            }
+            skipWhitespace(p, end);
+            if (p == end || *p != ':') {
+                return false;
+            }
+            ++p;
+            skipWhitespace(p, end);
+            if (p == end) {
+                return false;
+            }
+
+            if (*p == '"') {
+                const char *s;
+                std::size_t n;
+                if (!parseString(p, end, s, n)) {
+                    return false;
+                }
+                if (equals(key, keyLength, "msg")) {
+                    type = s;
+                    typeLength = n;
+                }
+            } else if (*p == '-' || (*p >= '0' && *p <= '9')) {
+                double v;
+                uint64_t integer;
+                bool isInteger;
+                if (!parseNumber(p, end, v, integer, isInteger)) {
+                    return false;
+                }
+                Field f = fieldOf(key, keyLength);
+                if (f != F_UNKNOWN) {
+                    values[f] = v;
+                    integers[f] = integer;
+                    present |= 1u << f;
+                    if (isInteger && integer <= std::numeric_limits<unsigned long>::max()) {
+                        integral |= 1u << f;
+                    } else {
+                        integral &= ~(1u << f);
+                    }
+                }
+            } else if (!skipLiteral(p, end, "true") && !skipLiteral(p, end, "false") && !skipLiteral(p, end, "null")) {
+                // nested objects and arrays are left to nlohmann
+                return false;
+            }
+
+            skipWhitespace(p, end);
+            if (p < end && *p == ',') {
+                ++p;
+                skipWhitespace(p, end);
+                continue;
+            }
+            if (p < end && *p == '}') {
+                ++p;
+                break;
+            }
+            return false;
+        }
+    }
+    skipWhitespace(p, end);
+    if (p != end) {
+        return false;
+    }
+
+    // counters are converted exactly, anything else in them is left to nlohmann
+    if ((present & INTEGER_FIELDS & ~integral) != 0) {
+        return false;
+    }
+
+    msg.stamp = (present & (1u << F_STAMP)) ? values[F_STAMP] : std::numeric_limits<double>::quiet_NaN();
+    if (type == nullptr) {
+        msg.name[0] = '\0';
+        msg.type = MessageType::None;
+        return true;
+    }
+
+    setName(msg, type, typeLength);
+    msg.type = typeOf(type, typeLength);
+    switch (msg.type) {
+    case MessageType::ImuRaw:
+        if ((present & IMU_FIELDS) != IMU_FIELDS) {
+            return false;
+        }
+        msg.imu.stamp = values[F_STAMP];
+        msg.imu.seq = (present & (1u << F_SEQ)) ? static_cast<unsigned long>(integers[F_SEQ]) : 0;
+        msg.imu.ax = values[F_AX];
+        msg.imu.ay = values[F_AY];
+        msg.imu.az = values[F_AZ];
+        msg.imu.wx = values[F_WX];
+        msg.imu.wy = values[F_WY];
+        msg.imu.wz = values[F_WZ];
+        break;
+    case MessageType::Heartbeat:
+        if ((present & HEARTBEAT_FIELDS) != HEARTBEAT_FIELDS) {
+            return false;
+        }
+        msg.heartbeat.stamp = values[F_STAMP];
+        msg.heartbeat.seq = static_cast<unsigned long>(integers[F_SEQ]);
+        break;
+    case MessageType::PressureRaw:
+        if ((present & PRESSURE_FIELDS) != PRESSURE_FIELDS) {
+            return false;
+        }
+        msg.pressure.stamp = values[F_STAMP];
+        msg.pressure.seq = (present & (1u << F_SEQ)) ? static_cast<unsigned long>(integers[F_SEQ]) : 0;
+        msg.pressure.pressure = static_cast<unsigned long>(integers[F_PRESSURE]);
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+MessageType decodeJson(const char *begin, const char *end, Message &msg)
+{
+    json data = json::parse(begin, end);
+
+    msg.stamp = std::numeric_limits<double>::quiet_NaN();
+    if (data.is_object() && data.contains("stamp") && data["stamp"].is_number()) {
+        msg.stamp = data["stamp"].get<double>();
+    }
+    if (!data.contains("msg")) {
+        msg.name[0] = '\0';
+        msg.type = MessageType::None;
+        return msg.type;
+    }
+
+    std::string type = data["msg"].get<std::string>();
+    setName(msg, type.data(), type.size());
+    msg.type = typeOf(type.data(), type.size());
+    switch (msg.type) {
+    case MessageType::ImuRaw:
+        msg.imu.stamp = data["stamp"].get<double>();
+        msg.imu.seq = data.value("seq", 0ul);
+        msg.imu.ax = data["ax"].get<double>();
+        msg.imu.ay = data["ay"].get<double>();
+        msg.imu.az = data["az"].get<double>();
+        msg.imu.wx = data["wx"].get<double>();
+        msg.imu.wy = data["wy"].get<double>();
+        msg.imu.wz = data["wz"].get<double>();
+        break;
+    case MessageType::Heartbeat:
+        msg.heartbeat.stamp = data["stamp"].get<double>();
+        msg.heartbeat.seq = data["seq"].get<unsigned long>();
+        break;
+    case MessageType::PressureRaw:
+        msg.pressure.stamp = data["stamp"].get<double>();
+        msg.pressure.seq = data.value("seq", 0ul);
+        msg.pressure.pressure = data["pressure"].get<unsigned long>();
+        break;
+    default:
+        break;
+    }
+    return msg.type;
+}
+
+}
+
+MessageType decodeMessage(const char *begin, const char *end, Message &msg)
+{
+    if (decodeFast(begin, end, msg)) {
+        return msg.type;
+    }
+    return decodeJson(begin, end, msg);
+}
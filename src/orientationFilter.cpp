@@ -0,0 +1,85 @@
+#include "orientationFilter.h"
+#include <cmath>
+
+MadgwickFilter::MadgwickFilter(double beta)
+    : beta_(beta)
+{
+    reset();
+}
+
+void MadgwickFilter::reset()
+{
+    initialized_ = false;
+    stamp_ = 0.0;
+    q_.setIdentity();
+}
+
+void MadgwickFilter::update(const ImuSample &sample)
+{
+    Eigen::Vector3d acc(sample.ax, sample.ay, sample.az);
+    Eigen::Vector3d gyro(sample.wx, sample.wy, sample.wz);
+
+    if (!initialized_) {
+        if (acc.squaredNorm() > 0.0) {
+            // rotate the measured gravity onto the earth z axis
+            q_ = Eigen::Quaterniond::FromTwoVectors(acc, Eigen::Vector3d::UnitZ());
+            initialized_ = true;
+        }
+        stamp_ = sample.stamp;
+        return;
+    }
+
+    double dt = sample.stamp - stamp_;
+    stamp_ = sample.stamp;
+    // skip samples out of order or after a long gap instead of integrating garbage
+    if (dt <= 0.0 || dt > 1.0) {
+        return;
+    }
+    update(acc, gyro, dt);
+}
+
+void MadgwickFilter::update(const Eigen::Vector3d &acc, const Eigen::Vector3d &gyro, double dt)
+{
+    double q0 = q_.w(), q1 = q_.x(), q2 = q_.y(), q3 = q_.z();
+
+    // rate of change from the gyroscope
+    Eigen::Vector4d qDot = 0.5 * Eigen::Vector4d(
+        -q1 * gyro.x() - q2 * gyro.y() - q3 * gyro.z(),
+         q0 * gyro.x() + q2 * gyro.z() - q3 * gyro.y(),
+         q0 * gyro.y() - q1 * gyro.z() + q3 * gyro.x(),
+         q0 * gyro.z() + q1 * gyro.y() - q2 * gyro.x());
+
+    double norm = acc.norm();
+    if (norm > 0.0) {
+        Eigen::Vector3d a = acc / norm;
+
+        // gradient descent step on the gravity direction error
+        Eigen::Vector3d f(
+            2.0 * (q1 * q3 - q0 * q2) - a.x(),
+            2.0 * (q0 * q1 + q2 * q3) - a.y(),
+            2.0 * (0.5 - q1 * q1 - q2 * q2) - a.z());
+        Eigen::Matrix<double, 3, 4> J;
+        J << -2.0 * q2,  2.0 * q3, -2.0 * q0, 2.0 * q1,
+              2.0 * q1,  2.0 * q0,  2.0 * q3, 2.0 * q2,
+              0.0,      -4.0 * q1, -4.0 * q2, 0.0;
+        Eigen::Vector4d step = J.transpose() * f;
+        double stepNorm = step.norm();
+        if (stepNorm > 0.0) {
+            qDot -= beta_ * step / stepNorm;
+        }
+    }
+
+    Eigen::Vector4d v = Eigen::Vector4d(q0, q1, q2, q3) + qDot * dt;
+    v.normalize();
+    q_ = Eigen::Quaterniond(v[0], v[1], v[2], v[3]);
+}
+
+Eigen::Vector3d MadgwickFilter::eulerAngles() const
+{
+    const Eigen::Quaterniond &q = q_;
+    double roll = std::atan2(2.0 * (q.w() * q.x() + q.y() * q.z()), 1.0 - 2.0 * (q.x() * q.x() + q.y() * q.y()));
+    double sinPitch = 2.0 * (q.w() * q.y() - q.z() * q.x());
+    double pitch = std::abs(sinPitch) >= 1.0 ? std::copysign(M_PI / 2.0, sinPitch) : std::asin(sinPitch);
+    double yaw = std::atan2(2.0 * (q.w() * q.z() + q.x() * q.y()), 1.0 - 2.0 * (q.y() * q.y() + q.z() * q.z()));
+    return Eigen::Vector3d(roll, pitch, yaw);
+}
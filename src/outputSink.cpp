@@ -0,0 +1,169 @@
+#include "outputSink.h"
+#include <algorithm>
+#include <cstring>
+
+OutputSink::OutputSink(std::size_t bufferSize, std::chrono::milliseconds flushInterval)
+    : buffer_(bufferSize), interval_(flushInterval), lastFlush_(std::chrono::steady_clock::now()),
+      file_(nullptr), ownsFile_(false), rotateBytes_(0), keep_(0), fileBytes_(0), failed_(false)
+{
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+OutputSink::~OutputSink()
+{
+    close();
+}
+
+void OutputSink::openStdout()
+{
+    close();
+    file_ = stdout;
+    ownsFile_ = false;
+    failed_ = false;
+}
+
+bool OutputSink::openFile(const std::string &path, std::size_t rotateBytes, int keep)
+{
+    close();
+    file_ = std::fopen(path.c_str(), "ab");
+    if (file_ == nullptr) {
+        return false;
+    }
+    // everything is buffered here already
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+    std::fseek(file_, 0, SEEK_END);
+    fileBytes_ = std::ftell(file_);
+    ownsFile_ = true;
+    failed_ = false;
+    path_ = path;
+    rotateBytes_ = rotateBytes;
+    keep_ = keep;
+    return true;
+}
+
+void OutputSink::close()
+{
+    flush();
+    if (ownsFile_ && file_ != nullptr) {
+        std::fclose(file_);
+    }
+    file_ = nullptr;
+    ownsFile_ = false;
+}
+
+void OutputSink::write(const char *data, std::size_t size)
+{
+    xsputn(data, size);
+}
+
+void OutputSink::writeLine(const LineView &line)
+{
+    xsputn(line.data, line.size);
+    sputc('\n');
+}
+
+void OutputSink::tick()
+{
+    if (pptr() != pbase() && std::chrono::steady_clock::now() - lastFlush_ >= interval_) {
+        flush();
+    }
+}
+
+void OutputSink::flush()
+{
+    if (pptr() != pbase()) {
+        writeOut(pbase(), pptr() - pbase());
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+    if (file_ != nullptr) {
+        std::fflush(file_);
+    }
+    lastFlush_ = std::chrono::steady_clock::now();
+}
+
+OutputSink::int_type OutputSink::overflow(int_type ch)
+{
+    flush();
+    if (failed_) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize OutputSink::xsputn(const char *s, std::streamsize n)
+{
+    std::streamsize written = 0;
+    while (written < n) {
+        std::streamsize space = epptr() - pptr();
+        if (space == 0) {
+            flush();
+            if (failed_) {
+                return written;
+            }
+            space = epptr() - pptr();
+        }
+        std::streamsize chunk = std::min(space, n - written);
+        std::memcpy(pptr(), s + written, chunk);
+        pbump(int(chunk));
+        written += chunk;
+    }
+    return n;
+}
+
+int OutputSink::sync()
+{
+    flush();
+    return failed_ ? -1 : 0;
+}
+
+void OutputSink::writeOut(const char *data, std::size_t size)
+{
+    if (file_ == nullptr) {
+        return;
+    }
+
+    if (rotateBytes_ > 0 && fileBytes_ + size >= rotateBytes_) {
+        // finish the current file at the last complete line
+        const char *end = data + size;
+        const char *nl = end;
+        while (nl > data && nl[-1] != '\n') {
+            --nl;
+        }
+        if (nl > data) {
+            std::fwrite(data, 1, nl - data, file_);
+            rotate();
+            if (file_ == nullptr) {
+                failed_ = true;
+                return;
+            }
+            data = nl;
+            size = end - nl;
+        }
+    }
+
+    std::fwrite(data, 1, size, file_);
+    fileBytes_ += size;
+}
+
+void OutputSink::rotate()
+{
+    std::fclose(file_);
+    if (keep_ > 0) {
+        std::remove((path_ + "." + std::to_string(keep_)).c_str());
+        for (int i = keep_ - 1; i >= 1; i--) {
+            std::rename((path_ + "." + std::to_string(i)).c_str(), (path_ + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(path_.c_str(), (path_ + ".1").c_str());
+    } else {
+        std::remove(path_.c_str());
+    }
+    file_ = std::fopen(path_.c_str(), "wb");
+    if (file_ != nullptr) {
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    }
+    fileBytes_ = 0;
+}
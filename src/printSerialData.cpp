@@ -1,12 +1,10 @@
 #include <asio/serial_port.hpp>
-#include <asio/read_until.hpp>
-#include <asio/streambuf.hpp>
-#include <nlohmann/json.hpp>
+#include "queuedSerialReader.h"
+#include "outputSink.h"
+#include "settings.h"
 #include <iostream>
-#include <fstream>
 #include <csignal>
-
-using json = nlohmann::json;
+#include <cstdlib>
 
 
 sig_atomic_t volatile running = true;
@@ -21,37 +19,53 @@ int main(int argc, char *argv[])
 {
     signal(SIGINT, &sigHandler);
     int a = 2;
-    std::ifstream configFile(CONFIG_JSON_FILE_PATH, std::ifstream::in);
-    json config = json::parse(configFile);
-
-    std::cout << "Opening port " << config["serial_port"].get<std::string>() << " with baudrate " << config["serial_baudrate"].get<int>() << "." << std::endl;
-    asio::io_context ctx;
-    asio::serial_port sensorcube(ctx);
-    sensorcube.open(config["serial_port"].get<std::string>());
-    sensorcube.set_option(asio::serial_port::baud_rate(config["serial_baudrate"].get<int>()));
-    sensorcube.set_option(asio::serial_port::flow_control(asio::serial_port::flow_control::none));
-    sensorcube.set_option(asio::serial_port::character_size(8));
-    sensorcube.set_option(asio::serial_port::parity(asio::serial_port::parity::none));
-    sensorcube.set_option(asio::serial_port::stop_bits(asio::serial_port::stop_bits::one));
-
-    asio::streambuf buf;
-    asio::read_until(sensorcube, buf, "\n");
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_SERIAL)) {
+        return -1;
+    }
+
+    std::cout << "Opening port " << settings.serialPort.port << " with baudrate " << settings.serialPort.baudrate << "." << std::endl;
+    QueuedSerialReader reader;
+    reader.addPort(settings.serialPort.port, settings.serialPort.baudrate);
+
+    // lines are batched and written out on size or every 100 ms instead of flushing each one
+    // printSerialData [<log file> [<rotate size in MB>]] writes to a rotating file instead of stdout
+    OutputSink sink;
+    if (argc > 1) {
+        std::size_t rotateBytes = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64) << 20;
+        if (!sink.openFile(argv[1], rotateBytes)) {
+            std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+            return -1;
+        }
+    } else {
+        sink.openStdout();
+    }
+
+    // the port is read on a background thread, this thread only decodes and prints
+    reader.start();
 
     while (running) {
-        asio::streambuf buf;
-        try {
-            asio::read_until(sensorcube, buf, "\n");
-        } catch (...) {
-            if (running) {
-                std::cerr << "Error: Failed reading from serial port!" << std::endl;
+        sink.tick();
+        const FramedLine *line = reader.next();
+        if (line == nullptr) {
+            if (reader.closed()) {
+                break;
             }
             continue;
         }
 
-        std::string line = asio::buffer_cast<const char*>(buf.data());
-        line.erase(line.find_last_not_of(" \n\r\t")+1);
+        sink.writeLine(line->view());
+        reader.pop();
+        if (sink.failed()) {
+            std::cerr << "Error: Unable to reopen " << argv[1] << " after rotating it!" << std::endl;
+            break;
+        }
+    }
 
-        std::cout << line << std::endl;
+    reader.stop();
+    sink.flush();
+    if (reader.overflows() > 0) {
+        std::cerr << "Warning: Dropped " << reader.overflows() << " of " << reader.received() + reader.overflows() << " lines, processing could not keep up!" << std::endl;
     }
 
     return 0;
@@ -1,66 +1,72 @@
-#include <nlohmann/json.hpp>
+#include "imuLog.h"
+#include "imuRecord.h"
+#include "imuKernels.h"
 #include <Eigen/Core>
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
 
-using json = nlohmann::json;
 
-
-void readIMU(const std::string &infile, Eigen::VectorXd &t, Eigen::VectorXd &ax, Eigen::VectorXd &ay,
-    Eigen::VectorXd &az, Eigen::VectorXd &wx, Eigen::VectorXd &wy, Eigen::VectorXd &wz)
+template<typename Scalar>
+void accelerationNorm(const ImuRecordBlock &block, Eigen::Ref<Eigen::VectorXd> a)
 {
-    std::ifstream ifs(infile, std::ifstream::in);
-
-    std::vector<double> _t, _ax, _ay, _az, _wx, _wy, _wz;
-
-    std::string line;
-    while (std::getline(ifs, line)) {
-        json data = json::parse(line);
-
-        if (!data.contains("msg")) {
-            continue;
-        }
-
-        if (data["msg"].get<std::string>().compare("imu_raw") == 0) {
-            double stamp = data["stamp"].get<double>();
-            unsigned long seq = data["seq"].get<unsigned long>();
-            _t.push_back(data["stamp"].get<double>());
-            _ax.push_back(data["ax"].get<double>());
-            _ay.push_back(data["ay"].get<double>());
-            _az.push_back(data["az"].get<double>());
-            _wx.push_back(data["wx"].get<double>());
-            _wy.push_back(data["wy"].get<double>());
-            _wz.push_back(data["wz"].get<double>());
-        }
-    }
-
-    t = Eigen::Map<Eigen::VectorXd>(_t.data(), _t.size());
-    ax = Eigen::Map<Eigen::VectorXd>(_ax.data(), _ax.size());
-    ay = Eigen::Map<Eigen::VectorXd>(_ay.data(), _ay.size());
-    az = Eigen::Map<Eigen::VectorXd>(_az.data(), _az.size());
-    wx = Eigen::Map<Eigen::VectorXd>(_wx.data(), _wx.size());
-    wy = Eigen::Map<Eigen::VectorXd>(_wy.data(), _wy.size());
-    wz = Eigen::Map<Eigen::VectorXd>(_wz.data(), _wz.size());
+    a = (block.channel<Scalar>(0).template cast<double>().square()
+        + block.channel<Scalar>(1).template cast<double>().square()
+        + block.channel<Scalar>(2).template cast<double>().square()).sqrt().matrix();
 }
 
 int main(int argc, char *argv[])
 {
     if (argc <= 1) {
         std::cout << "Input file required!" << std::endl;
-        std::cout << "Usage: processIMU <input file>" << std::endl;
+        std::cout << "Usage: processIMU <input file> [<start stamp> <end stamp>]" << std::endl;
         return -1;
     }
+    bool window = argc > 3;
+
+    Eigen::VectorXd a;
+    ImuRecordReader record;
+    if (window) {
+        // only the blocks overlapping the window are read
+        ImuData imu;
+        if (!record.open(argv[1])) {
+            std::cerr << "Error: A time window requires a binary recording, see convertIMU!" << std::endl;
+            return -1;
+        }
+        record.readWindow(std::atof(argv[2]), std::atof(argv[3]), imu);
+
+        std::cout << "Loaded " << imu.size() << " IMU messages." << std::endl;
 
-    Eigen::VectorXd t, ax, ay, az, wx, wy, wz;
-    readIMU(std::string(argv[1]), t, ax, ay, az, wx, wy, wz);
+        a = accelerationNorm(imu).matrix();
+    } else if (record.open(argv[1])) {
+        std::cout << "Loaded " << record.size() << " IMU messages." << std::endl;
 
-    std::cout << "Loaded " << t.size() << " IMU messages." << std::endl;
+        // binary recordings are processed straight from the mapped blocks
+        a.resize(record.size());
+        Eigen::Index row = 0;
+        for (std::size_t i = 0; i < record.blockCount(); i++) {
+            const ImuRecordBlock &block = record.block(i);
+            if (block.isFloat(0)) {
+                accelerationNorm<float>(block, a.segment(row, block.count));
+            } else {
+                accelerationNorm<double>(block, a.segment(row, block.count));
+            }
+            row += block.count;
+        }
+    } else {
+        ImuData imu;
+        if (!loadIMU(std::string(argv[1]), imu)) {
+            std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+            return -1;
+        }
 
-    // process IMU data
+        std::cout << "Loaded " << imu.size() << " IMU messages." << std::endl;
 
-    // compute norm of the acceleration vector
-    //a = np.sqrt(ax*ax + ay*ay + az*az)
-    Eigen::VectorXd a = (ax.array() * ax.array() + ay.array() * ay.array() + az.array() * az.array()).cwiseSqrt();
+        // process IMU data
+
+        // compute norm of the acceleration vector
+        //a = np.sqrt(ax*ax + ay*ay + az*az)
+        a = accelerationNorm(imu).matrix();
+    }
 
     std::cout << "a = " << std::endl << a << std::endl;
 
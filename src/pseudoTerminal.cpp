@@ -0,0 +1,113 @@
+#include "pseudoTerminal.h"
+
+#if defined(LINUX_OS) || defined(MACOS_OS)
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#define HAVE_PTY
+#endif
+
+PseudoTerminal::PseudoTerminal()
+    : master_(-1), slave_(-1)
+{
+}
+
+PseudoTerminal::~PseudoTerminal()
+{
+    close();
+}
+
+#ifdef HAVE_PTY
+
+bool PseudoTerminal::open()
+{
+    close();
+
+    master_ = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_ < 0) {
+        return false;
+    }
+    const char *name = nullptr;
+    if (grantpt(master_) != 0 || unlockpt(master_) != 0 || (name = ptsname(master_)) == nullptr) {
+        close();
+        return false;
+    }
+    slaveName_ = name;
+
+    // raw mode, otherwise the line discipline echoes and rewrites the data
+    slave_ = ::open(name, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    if (slave_ < 0 || tcgetattr(slave_, &tio) != 0) {
+        close();
+        return false;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(slave_, TCSANOW, &tio);
+    return true;
+}
+
+void PseudoTerminal::close()
+{
+    if (slave_ >= 0) {
+        ::close(slave_);
+        slave_ = -1;
+    }
+    if (master_ >= 0) {
+        ::close(master_);
+        master_ = -1;
+    }
+    slaveName_.clear();
+}
+
+bool PseudoTerminal::write(const char *data, std::size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::write(master_, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= std::size_t(n);
+    }
+    return true;
+}
+
+long PseudoTerminal::read(char *data, std::size_t size, int timeoutMs)
+{
+    struct pollfd pfd = {master_, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) {
+        return ready < 0 && errno != EINTR ? -1 : 0;
+    }
+    ssize_t n = ::read(master_, data, size);
+    return n < 0 ? -1 : long(n);
+}
+
+#else
+
+bool PseudoTerminal::open()
+{
+    return false;
+}
+
+void PseudoTerminal::close()
+{
+}
+
+bool PseudoTerminal::write(const char *, std::size_t)
+{
+    return false;
+}
+
+long PseudoTerminal::read(char *, std::size_t, int)
+{
+    return -1;
+}
+
+#endif
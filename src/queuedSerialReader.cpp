@@ -0,0 +1,73 @@
+#include "queuedSerialReader.h"
+#include <chrono>
+#include <cstring>
+
+QueuedSerialReader::QueuedSerialReader(std::size_t slots)
+    : queue_(slots),
+      engine_([this](std::size_t port, const LineView &line) { frame(port, line); }),
+      truncated_(0), finished_(false)
+{
+}
+
+QueuedSerialReader::~QueuedSerialReader()
+{
+    stop();
+}
+
+std::size_t QueuedSerialReader::addPort(const std::string &device, int baudrate)
+{
+    return engine_.addPort(device, baudrate);
+}
+
+void QueuedSerialReader::start()
+{
+    finished_ = false;
+    thread_ = std::thread([this]() {
+        engine_.run();
+        finished_.store(true, std::memory_order_release);
+    });
+}
+
+void QueuedSerialReader::stop()
+{
+    engine_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void QueuedSerialReader::frame(std::size_t port, const LineView &line)
+{
+    // a cut off line would decode as garbage or not at all, so it is dropped
+    if (line.size > FRAMED_LINE_CAPACITY) {
+        truncated_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    FramedLine *slot = queue_.beginPush();
+    if (slot == nullptr) {
+        return;
+    }
+    std::size_t size = line.size;
+    slot->received = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    slot->port = uint32_t(port);
+    slot->size = uint32_t(size);
+    std::memcpy(slot->data, line.data, size);
+    queue_.commitPush();
+}
+
+const FramedLine *QueuedSerialReader::next()
+{
+    // spin briefly, then back off so an idle consumer does not burn a core
+    for (int i = 0; i < 64; i++) {
+        const FramedLine *line = queue_.front();
+        if (line != nullptr) {
+            return line;
+        }
+        if (i < 16) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    }
+    return nullptr;
+}
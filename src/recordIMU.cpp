@@ -0,0 +1,99 @@
+#include <asio/serial_port.hpp>
+#include <asio/write.hpp>
+#include "serialReader.h"
+#include "messageDecoder.h"
+#include "imuRecord.h"
+#include "imuStatistics.h"
+#include "settings.h"
+#include <iostream>
+#include <csignal>
+
+
+sig_atomic_t volatile running = true;
+void sigHandler(int signum)
+{
+    if (signum == SIGINT) {
+        running = false;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc <= 1) {
+        std::cout << "Output file required!" << std::endl;
+        std::cout << "Usage: recordIMU <output file>" << std::endl;
+        return -1;
+    }
+
+    signal(SIGINT, &sigHandler);
+
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_SERIAL)) {
+        return -1;
+    }
+
+    ImuRecordWriter recorder;
+    if (!recorder.open(argv[1])) {
+        std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+        return -1;
+    }
+
+    std::cout << "Opening port " << settings.serialPort.port << " with baudrate " << settings.serialPort.baudrate << "." << std::endl;
+    asio::io_context ctx;
+    asio::serial_port sensorcube(ctx);
+    sensorcube.open(settings.serialPort.port);
+    sensorcube.set_option(asio::serial_port::baud_rate(settings.serialPort.baudrate));
+    sensorcube.set_option(asio::serial_port::flow_control(asio::serial_port::flow_control::none));
+    sensorcube.set_option(asio::serial_port::character_size(8));
+    sensorcube.set_option(asio::serial_port::parity(asio::serial_port::parity::none));
+    sensorcube.set_option(asio::serial_port::stop_bits(asio::serial_port::stop_bits::one));
+
+    std::string command = "{\"messages\":[\"imu_raw\"]}\r\n";
+    asio::write(sensorcube, asio::buffer(command.data(), command.length()));
+
+    SerialReader reader(sensorcube);
+    // skip the first, possibly incomplete line
+    reader.readLine();
+
+    Message msg;
+    ImuStatistics stats;
+    unsigned long failed = 0;
+    while (running) {
+        LineView line;
+        try {
+            line = reader.readLine();
+        } catch (...) {
+            if (running) {
+                std::cerr << "Error: Failed reading from serial port!" << std::endl;
+            }
+            continue;
+        }
+
+        // a malformed line must not end the recording before the buffered block and the index are written
+        MessageType type;
+        try {
+            type = decodeMessage(line.begin(), line.end(), msg);
+        } catch (...) {
+            failed++;
+            continue;
+        }
+        if (type == MessageType::ImuRaw) {
+            recorder.write(msg.imu);
+            stats.add(msg.imu);
+        }
+    }
+
+    recorder.close();
+    std::cout << "Recorded " << stats.count() << " IMU messages." << std::endl;
+    if (failed > 0) {
+        std::cerr << "Warning: " << failed << " lines could not be decoded!" << std::endl;
+    }
+
+    const char *names[] = {"Acc X", "Acc Y", "Acc Z", "Gyr X", "Gyr Y", "Gyr Z"};
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        std::cout << names[c] << ": Mean: " << stats.mean(c) << "\tStdDev: " << stats.stdDev(c)
+            << "\tMin: " << stats.min()[c] << "\tMax: " << stats.max()[c] << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "logReplay.h"
+#include "outputSink.h"
+#include "pseudoTerminal.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <csignal>
+
+
+sig_atomic_t volatile running = true;
+void sigHandler(int signum)
+{
+    if (signum == SIGINT) {
+        running = false;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc <= 1) {
+        std::cout << "Input file required!" << std::endl;
+        std::cout << "Usage: replaySerialData <input file> [<speed, 0 = as fast as possible> [pty [<s to wait for a command>]]]" << std::endl;
+        return -1;
+    }
+
+    signal(SIGINT, &sigHandler);
+
+    LogReplay replay;
+    if (!replay.open(argv[1])) {
+        std::cerr << "Error: Unable to open " << argv[1] << "!" << std::endl;
+        return -1;
+    }
+    double speed = argc > 2 ? std::strtod(argv[2], nullptr) : 1.0;
+    bool usePty = argc > 3 && std::strcmp(argv[3], "pty") == 0;
+    // subscribing consumers send a command right after opening the port, the others never do
+    double commandWait = argc > 4 ? std::strtod(argv[4], nullptr) : 2.0;
+
+    // the serial tools read the pty like a cube once "serial_port" points at it
+    PseudoTerminal pty;
+    OutputSink sink;
+    char command[256];
+    if (usePty) {
+        if (!pty.open()) {
+            std::cerr << "Error: Unable to open a pseudo-terminal!" << std::endl;
+            return -1;
+        }
+        std::cout << "Replaying on " << pty.slaveName() << ", starting on the first command or after "
+            << commandWait << " s." << std::endl;
+        long n = 0;
+        for (double waited = 0.0; running && n == 0 && waited < commandWait; waited += 0.1) {
+            n = pty.read(command, sizeof(command), 100);
+        }
+        if (n < 0) {
+            std::cerr << "Error: Reading from the pseudo-terminal failed!" << std::endl;
+            return -1;
+        }
+    } else {
+        sink.openStdout();
+    }
+
+    // unpaced replay is written in chunks, paced lines right away
+    std::string chunk;
+    chunk.reserve(1 << 16);
+    ReplayClock clock(speed);
+    LineView line;
+    double stamp;
+    unsigned long lines = 0;
+    double maxLag = 0.0;
+    while (running && replay.next(line, stamp)) {
+        clock.wait(stamp);
+        maxLag = std::max(maxLag, clock.lag());
+        lines++;
+        if (!usePty) {
+            sink.writeLine(line);
+            sink.tick();
+            continue;
+        }
+
+        chunk.append(line.data, line.size);
+        chunk += "\r\n";
+        if (speed > 0.0 || chunk.size() >= (1 << 15)) {
+            if (!pty.write(chunk.data(), chunk.size())) {
+                std::cerr << "Error: Writing to the pseudo-terminal failed!" << std::endl;
+                return -1;
+            }
+            chunk.clear();
+            // drop further commands, the replay sends everything in the log
+            pty.read(command, sizeof(command), 0);
+        }
+    }
+    if (usePty) {
+        pty.write(chunk.data(), chunk.size());
+    }
+    sink.flush();
+
+    std::cerr << "Replayed " << lines << " lines";
+    if (speed > 0.0) {
+        std::cerr << ", up to " << maxLag * 1000.0 << " ms behind the requested timing";
+    }
+    std::cerr << "." << std::endl;
+
+    if (usePty) {
+        // keep the port open until the consumer has read the rest
+        std::cout << "Done, press Ctrl+C to close the pseudo-terminal." << std::endl;
+        while (running) {
+            pty.read(command, sizeof(command), 100);
+        }
+    }
+
+    return 0;
+}
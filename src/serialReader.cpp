@@ -0,0 +1,82 @@
+#include "serialReader.h"
+#include <cstring>
+
+LineBuffer::LineBuffer(std::size_t capacity)
+    : buffer_(capacity), begin_(0), scan_(0), end_(0), discarding_(false), dropped_(0)
+{
+}
+
+bool LineBuffer::nextLine(LineView &line)
+{
+    while (scan_ < end_) {
+        const char *start = buffer_.data() + scan_;
+        const char *nl = static_cast<const char*>(std::memchr(start, '\n', end_ - scan_));
+        if (nl == nullptr) {
+            scan_ = end_;
+            return false;
+        }
+
+        std::size_t lineBegin = begin_;
+        std::size_t lineEnd = nl - buffer_.data();
+        begin_ = scan_ = lineEnd + 1;
+
+        if (discarding_) {
+            dropped_ += lineEnd + 1 - lineBegin;
+            discarding_ = false;
+            continue;
+        }
+
+        while (lineEnd > lineBegin) {
+            char c = buffer_[lineEnd - 1];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                break;
+            }
+            --lineEnd;
+        }
+        line.data = buffer_.data() + lineBegin;
+        line.size = lineEnd - lineBegin;
+        return true;
+    }
+    return false;
+}
+
+char *LineBuffer::prepare(std::size_t &size)
+{
+    if (end_ == buffer_.size()) {
+        if (begin_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            scan_ -= begin_;
+            begin_ = 0;
+        } else {
+            // line does not fit into the buffer, drop it up to the next newline
+            dropped_ += end_;
+            discarding_ = true;
+            begin_ = scan_ = end_ = 0;
+        }
+    }
+
+    size = buffer_.size() - end_;
+    return buffer_.data() + end_;
+}
+
+void LineBuffer::commit(std::size_t size)
+{
+    end_ += size;
+}
+
+SerialReader::SerialReader(asio::serial_port &port, std::size_t capacity)
+    : port_(port), buffer_(capacity)
+{
+}
+
+LineView SerialReader::readLine()
+{
+    LineView line;
+    while (!buffer_.nextLine(line)) {
+        std::size_t size;
+        char *data = buffer_.prepare(size);
+        buffer_.commit(port_.read_some(asio::buffer(data, size)));
+    }
+    return line;
+}
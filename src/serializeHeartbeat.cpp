@@ -1,14 +1,15 @@
-#include <asio/serial_port.hpp>
-#include <asio/read_until.hpp>
-#include <asio/streambuf.hpp>
-#include <asio/write.hpp>
-#include <nlohmann/json.hpp>
+#include "queuedSerialReader.h"
+#include "outputSink.h"
+#include "messageDecoder.h"
+#include "linkMonitor.h"
+#include "settings.h"
+#include "commandChannel.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
-#include <fstream>
 #include <csignal>
 
-using json = nlohmann::json;
-
 
 sig_atomic_t volatile running = true;
 void sigHandler(int signum)
@@ -22,52 +23,89 @@ int main(int argc, char *argv[])
 {
     signal(SIGINT, &sigHandler);
 
-    std::ifstream configFile(CONFIG_JSON_FILE_PATH, std::ifstream::in);
-    json config = json::parse(configFile);
+    // with a report interval the tool only publishes link statistics instead of every heartbeat
+    bool monitor = argc > 1;
+    double interval = monitor ? std::strtod(argv[1], nullptr) : 0.0;
+    if (monitor && !(interval > 0.0)) {
+        std::cout << "Usage: serializeHeartbeat [<report interval in s>]" << std::endl;
+        return -1;
+    }
+
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_SERIAL)) {
+        return -1;
+    }
+
+    std::cout << "Opening port " << settings.serialPort.port << " with baudrate " << settings.serialPort.baudrate << "." << std::endl;
+    QueuedSerialReader reader;
+    reader.addPort(settings.serialPort.port, settings.serialPort.baudrate);
 
-    std::cout << "Opening port " << config["serial_port"].get<std::string>() << " with baudrate " << config["serial_baudrate"].get<int>() << "." << std::endl;
-    asio::io_context ctx;
-    asio::serial_port sensorcube(ctx);
-    sensorcube.open(config["serial_port"].get<std::string>());
-    sensorcube.set_option(asio::serial_port::baud_rate(config["serial_baudrate"].get<int>()));
-    sensorcube.set_option(asio::serial_port::baud_rate(config["serial_baudrate"].get<int>()));
-    sensorcube.set_option(asio::serial_port::flow_control(asio::serial_port::flow_control::none));
-    sensorcube.set_option(asio::serial_port::character_size(8));
-    sensorcube.set_option(asio::serial_port::parity(asio::serial_port::parity::none));
-    sensorcube.set_option(asio::serial_port::stop_bits(asio::serial_port::stop_bits::one));
+    // the subscription is written by the reader thread and resent until the messages arrive
+    CommandChannel commands([&reader](const std::string &command) { reader.write(0, command); });
+    commands.subscribe("heartbeat");
+    commands.flush();
 
-    std::string command = "{\"messages\":[\"heartbeat\"]}\r\n";
-    asio::write(sensorcube, asio::buffer(command.data(), command.length()));
+    // lines are batched and written out on size or every 100 ms instead of flushing each one
+    OutputSink sink;
+    sink.openStdout();
+    std::ostream out(&sink);
 
-    asio::streambuf buf;
-    asio::read_until(sensorcube, buf, "\n");
+    // the port is read on a background thread, this thread only decodes and prints
+    reader.start();
 
+    HeartbeatMonitor link;
+    std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval));
+    std::chrono::steady_clock::time_point nextReport = std::chrono::steady_clock::now() + period;
+
+    Message msg;
+    unsigned long failed = 0;
     while (running) {
-        asio::streambuf buf;
-        try {
-            asio::read_until(sensorcube, buf, "\n");
-        } catch (...) {
-            if (running) {
-                std::cerr << "Error: Failed reading from serial port!" << std::endl;
+        sink.tick();
+        commands.tick();
+        if (monitor && std::chrono::steady_clock::now() >= nextReport) {
+            nextReport += period;
+            link.report(out, std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+        const FramedLine *line = reader.next();
+        if (line == nullptr) {
+            if (reader.closed()) {
+                break;
             }
             continue;
         }
 
-        std::string line = asio::buffer_cast<const char*>(buf.data());
-        line.erase(line.find_last_not_of(" \n\r\t")+1);
-
-        json data = json::parse(line);
-
-        if (!data.contains("msg")) {
+        MessageType type;
+        try {
+            type = decodeMessage(line->begin(), line->end(), msg);
+        } catch (...) {
+            failed++;
+            reader.pop();
             continue;
         }
+        commands.received(msg.name);
+        double received = line->received;
+        reader.pop();
 
-        if (data["msg"].get<std::string>().compare("heartbeat") == 0) {
-            double stamp = data["stamp"].get<double>();
-            unsigned long seq = data["seq"].get<unsigned long>();
-            std::cout << "Received heartbeat at time " << std::setiosflags(std::ios_base::fixed) << std::setprecision(3) << stamp << " with sequence number " << seq << "." << std::endl;
+        if (type == MessageType::Heartbeat && monitor) {
+            link.update(msg.heartbeat, received);
+        } else if (type == MessageType::Heartbeat) {
+            double stamp = msg.heartbeat.stamp;
+            unsigned long seq = msg.heartbeat.seq;
+            out << "Received heartbeat at time " << std::setiosflags(std::ios_base::fixed) << std::setprecision(3) << stamp << " with sequence number " << seq << ".\n";
         }
     }
 
+    reader.stop();
+    sink.flush();
+    if (commands.failed()) {
+        std::cerr << "Warning: The SensorCube did not send the subscribed messages after " << commands.commands() << " commands!" << std::endl;
+    }
+    if (reader.overflows() > 0) {
+        std::cerr << "Warning: Dropped " << reader.overflows() << " of " << reader.received() + reader.overflows() << " lines, processing could not keep up!" << std::endl;
+    }
+    if (failed > 0 || reader.truncated() > 0) {
+        std::cerr << "Warning: " << failed << " lines could not be decoded, " << reader.truncated() << " were too long!" << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,301 @@
+#include "settings.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using json = nlohmann::json;
+
+namespace {
+
+const char *KNOWN_KEYS[] = {
+    "serial_port", "serial_baudrate", "serial_ports", "ingestion_threads",
+    "camera_index", "camera_width", "camera_height"
+};
+
+const char CACHE_MAGIC[8] = {'S', 'C', 'C', 'O', 'N', 'F', 'I', 'G'};
+const uint32_t CACHE_VERSION = 2;
+
+// number of single character edits between a and b, to suggest a key for a typo
+std::size_t editDistance(const std::string &a, const std::string &b)
+{
+    std::vector<std::size_t> row(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); j++) {
+        row[j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); i++) {
+        std::size_t diagonal = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= b.size(); j++) {
+            std::size_t above = row[j];
+            row[j] = std::min(std::min(row[j] + 1, row[j - 1] + 1), diagonal + (a[i - 1] == b[j - 1] ? 0 : 1));
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+bool getInt(const json &config, const char *key, int min, int &value, std::string &error)
+{
+    const json &v = config[key];
+    if (!v.is_number_integer() || v.get<long long>() < min || v.get<long long>() > 0x7fffffff) {
+        error = std::string("\"") + key + "\" must be an integer of at least " + std::to_string(min);
+        return false;
+    }
+    value = v.get<int>();
+    return true;
+}
+
+bool getPort(const json &entry, const char *portKey, const char *baudKey, SerialPortSettings &port, std::string &error)
+{
+    if (!entry.contains(portKey) || !entry[portKey].is_string() || entry[portKey].get<std::string>().empty()) {
+        error = std::string("\"") + portKey + "\" must be a device name";
+        return false;
+    }
+    if (!entry.contains(baudKey)) {
+        error = std::string("\"") + baudKey + "\" is missing for " + entry[portKey].get<std::string>();
+        return false;
+    }
+    port.port = entry[portKey].get<std::string>();
+    return getInt(entry, baudKey, 1, port.baudrate, error);
+}
+
+// identifies the config contents, modification times are too coarse on many file systems
+struct FileStamp {
+    uint64_t size;
+    uint64_t hash;
+};
+
+bool readFile(const std::string &path, std::string &contents, FileStamp &stamp)
+{
+    std::ifstream file(path, std::ifstream::in | std::ifstream::binary);
+    if (!file) {
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        return false;
+    }
+    // 64 bit FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : contents) {
+        hash = (hash ^ uint64_t(static_cast<unsigned char>(c))) * 0x100000001b3ull;
+    }
+    stamp.size = contents.size();
+    stamp.hash = hash;
+    return true;
+}
+
+template<typename T>
+bool readValue(std::FILE *f, T &value)
+{
+    return std::fread(&value, sizeof(T), 1, f) == 1;
+}
+
+template<typename T>
+void writeValue(std::FILE *f, const T &value)
+{
+    std::fwrite(&value, sizeof(T), 1, f);
+}
+
+bool readPort(std::FILE *f, SerialPortSettings &port)
+{
+    uint32_t length = 0;
+    if (!readValue(f, length) || length >= 4096) {
+        return false;
+    }
+    port.port.resize(length);
+    return (length == 0 || std::fread(&port.port[0], length, 1, f) == 1) && readValue(f, port.baudrate);
+}
+
+void writePort(std::FILE *f, const SerialPortSettings &port)
+{
+    writeValue(f, uint32_t(port.port.size()));
+    std::fwrite(port.port.data(), 1, port.port.size(), f);
+    writeValue(f, port.baudrate);
+}
+
+bool readCache(const std::string &cachePath, const FileStamp &source, Settings &settings)
+{
+    std::FILE *f = std::fopen(cachePath.c_str(), "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    char magic[sizeof(CACHE_MAGIC)];
+    uint32_t version = 0, ports = 0;
+    FileStamp stamp;
+    bool ok = std::fread(magic, sizeof(magic), 1, f) == 1 && std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) == 0
+        && readValue(f, version) && version == CACHE_VERSION
+        && readValue(f, stamp.size) && readValue(f, stamp.hash)
+        && stamp.size == source.size && stamp.hash == source.hash
+        && readValue(f, settings.groups) && readPort(f, settings.serialPort) && readValue(f, ports) && ports < 1024;
+    settings.serialPorts.resize(ok ? ports : 0);
+    for (std::size_t i = 0; ok && i < settings.serialPorts.size(); i++) {
+        ok = readPort(f, settings.serialPorts[i]);
+    }
+    ok = ok && readValue(f, settings.ingestionThreads) && readValue(f, settings.cameraIndex)
+        && readValue(f, settings.cameraWidth) && readValue(f, settings.cameraHeight);
+    std::fclose(f);
+    return ok;
+}
+
+void writeCache(const std::string &cachePath, const FileStamp &source, const Settings &settings)
+{
+    // written to a temporary file first, so concurrently starting tools never read half a cache
+    std::string tmpPath = cachePath + ".tmp";
+    std::FILE *f = std::fopen(tmpPath.c_str(), "wb");
+    if (f == nullptr) {
+        return;
+    }
+    std::fwrite(CACHE_MAGIC, sizeof(CACHE_MAGIC), 1, f);
+    writeValue(f, CACHE_VERSION);
+    writeValue(f, source.size);
+    writeValue(f, source.hash);
+    writeValue(f, settings.groups);
+    writePort(f, settings.serialPort);
+    writeValue(f, uint32_t(settings.serialPorts.size()));
+    for (const SerialPortSettings &p : settings.serialPorts) {
+        writePort(f, p);
+    }
+    writeValue(f, settings.ingestionThreads);
+    writeValue(f, settings.cameraIndex);
+    writeValue(f, settings.cameraWidth);
+    writeValue(f, settings.cameraHeight);
+    bool ok = std::ferror(f) == 0;
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+    }
+}
+
+}
+
+Settings::Settings()
+    : groups(0), ingestionThreads(1), cameraIndex(0), cameraWidth(0), cameraHeight(0)
+{
+}
+
+bool parseSettings(const json &config, Settings &settings, std::string &error)
+{
+    settings = Settings();
+    error.clear();
+    if (!config.is_object()) {
+        error = "the config must be a JSON object";
+        return false;
+    }
+
+    // unknown keys are only reported, the file is shared with the Python scripts
+    for (json::const_iterator it = config.begin(); it != config.end(); ++it) {
+        const char *closest = nullptr;
+        std::size_t distance = 3;
+        for (const char *known : KNOWN_KEYS) {
+            std::size_t d = editDistance(it.key(), known);
+            if (d < distance) {
+                distance = d;
+                closest = known;
+            }
+        }
+        if (distance > 0 && closest != nullptr) {
+            std::cerr << "Warning: Unknown config key \"" << it.key() << "\", did you mean \"" << closest << "\"?" << std::endl;
+        }
+    }
+
+    bool single = config.contains("serial_port") || config.contains("serial_baudrate");
+    if (single && !getPort(config, "serial_port", "serial_baudrate", settings.serialPort, error)) {
+        return false;
+    }
+    if (config.contains("serial_ports")) {
+        const json &ports = config["serial_ports"];
+        if (!ports.is_array()) {
+            error = "\"serial_ports\" must be an array of {\"port\", \"baudrate\"} objects";
+            return false;
+        }
+        for (const json &entry : ports) {
+            SerialPortSettings port;
+            if (!entry.is_object() || !getPort(entry, "port", "baudrate", port, error)) {
+                error = "\"serial_ports\": " + (error.empty() ? std::string("entries must be objects") : error);
+                return false;
+            }
+            settings.serialPorts.push_back(port);
+        }
+    }
+    if (single && settings.serialPorts.empty()) {
+        settings.serialPorts.push_back(settings.serialPort);
+    } else if (!single && !settings.serialPorts.empty()) {
+        settings.serialPort = settings.serialPorts.front();
+    }
+    if (!settings.serialPorts.empty()) {
+        settings.groups |= SETTINGS_SERIAL;
+    }
+    if (config.contains("ingestion_threads")) {
+        int threads;
+        if (!getInt(config, "ingestion_threads", 1, threads, error)) {
+            return false;
+        }
+        settings.ingestionThreads = unsigned(threads);
+    }
+
+    int cameraKeys = int(config.contains("camera_index")) + int(config.contains("camera_width")) + int(config.contains("camera_height"));
+    if (cameraKeys > 0) {
+        if (cameraKeys < 3) {
+            error = "\"camera_index\", \"camera_width\" and \"camera_height\" must be given together";
+            return false;
+        }
+        if (!getInt(config, "camera_index", 0, settings.cameraIndex, error)
+            || !getInt(config, "camera_width", 1, settings.cameraWidth, error)
+            || !getInt(config, "camera_height", 1, settings.cameraHeight, error)) {
+            return false;
+        }
+        settings.groups |= SETTINGS_CAMERA;
+    }
+    return true;
+}
+
+bool loadSettings(const std::string &path, const std::string &cachePath, Settings &settings, unsigned int required)
+{
+    std::string contents;
+    FileStamp stamp;
+    if (!readFile(path, contents, stamp)) {
+        std::cerr << "Error: Unable to open config file " << path << "!" << std::endl;
+        return false;
+    }
+
+    if (cachePath.empty() || !readCache(cachePath, stamp, settings)) {
+        json config = json::parse(contents, nullptr, false);
+        if (config.is_discarded()) {
+            std::cerr << "Error: " << path << " is not valid JSON!" << std::endl;
+            return false;
+        }
+        std::string error;
+        if (!parseSettings(config, settings, error)) {
+            std::cerr << "Error: " << path << ": " << error << "!" << std::endl;
+            return false;
+        }
+        if (!cachePath.empty()) {
+            writeCache(cachePath, stamp, settings);
+        }
+    }
+
+    if ((required & SETTINGS_SERIAL) != 0 && (settings.groups & SETTINGS_SERIAL) == 0) {
+        std::cerr << "Error: " << path << ": \"serial_port\" and \"serial_baudrate\" are required!" << std::endl;
+        return false;
+    }
+    if ((required & SETTINGS_CAMERA) != 0 && (settings.groups & SETTINGS_CAMERA) == 0) {
+        std::cerr << "Error: " << path << ": \"camera_index\", \"camera_width\" and \"camera_height\" are required!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadSettings(Settings &settings, unsigned int required)
+{
+#ifdef CONFIG_CACHE_FILE_PATH
+    return loadSettings(CONFIG_JSON_FILE_PATH, CONFIG_CACHE_FILE_PATH, settings, required);
+#else
+    return loadSettings(CONFIG_JSON_FILE_PATH, std::string(), settings, required);
+#endif
+}
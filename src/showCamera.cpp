@@ -1,61 +1,155 @@
 #include <opencv2/core.hpp>
-#include <opencv2/videoio.hpp>
 #include <opencv2/highgui.hpp>
-#include <nlohmann/json.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include "capturePipeline.h"
+#include "frameRecorder.h"
+#include "settings.h"
+#include "stereoRectifier.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
-#include <fstream>
-
-using json = nlohmann::json;
+#include <string>
+#include <thread>
 
 
 int main(int argc, char *argv[])
 {
-    std::ifstream configFile(CONFIG_JSON_FILE_PATH, std::ifstream::in);
-    json config = json::parse(configFile);
-
-    cv::Mat frame;
-    cv::VideoCapture cap;
+    // showCamera [<record directory> [png|jpg|raw]] records every frame in the background
+    bool record = argc > 1;
+    FrameFormat format = FrameFormat::Png;
+    if (argc > 2 && !parseFrameFormat(argv[2], format)) {
+        std::cout << "Usage: showCamera [<record directory> [png|jpg|raw]]" << std::endl;
+        return -1;
+    }
 
-    int apiPreference = cv::CAP_ANY;
-#ifdef LINUX_OS
-    apiPreference = cv::CAP_V4L;
-#endif
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_CAMERA)) {
+        return -1;
+    }
 
-    cap.open(config["camera_index"].get<int>(), apiPreference);
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, config["camera_width"].get<int>());
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, config["camera_height"].get<int>());
-    int fourcc = cv::VideoWriter::fourcc('B', 'G', 'R', '3');
-    cap.set(cv::CAP_PROP_FOURCC, fourcc);
+    // a few encoders keep up with the camera, more would only hold more frames
+    FrameRecorder recorder(format, std::min(4u, std::max(1u, std::thread::hardware_concurrency())), 16);
 
-    if (!cap.isOpened()) {
+    // frames are grabbed on a background thread, display and snapshots consume them independently.
+    // The pool covers every frame that can be referenced at once: the consumer queues, one frame
+    // in each consumer thread, the recorder and the frame being grabbed. The recording consumer
+    // and its thread only exist while recording.
+    const std::size_t displayQueue = 2, snapshotQueue = 2, recordingQueue = 4;
+    std::size_t poolSize = displayQueue + snapshotQueue + 2 + 1;
+    if (record) {
+        poolSize += recordingQueue + 1 + recorder.capacity();
+    }
+    CapturePipeline capture(poolSize);
+    if (!capture.open(settings)) {
         std::cerr << "Error: Unable to open camera!" << std::endl;
         return -1;
     }
- 
-    int imageSeq = 0;
-    for (;;) {
-        cap.read(frame);
+    // r toggles the rectified view, the maps are built once for the camera resolution
+    StereoRectifier rectifier;
+    bool rectify = false;
+    if (!rectifier.load(CALIBRATION_FILE_PATH, capture.width(), capture.height())) {
+        std::cerr << "Warning: No stereo calibration, rectified view disabled." << std::endl;
+    }
 
-        if (frame.empty()) {
-            std::cerr << "Error: Blank frame grabbed!" << std::endl;
-            break;
+    FrameConsumer &display = capture.addConsumer(displayQueue);
+    FrameConsumer &snapshots = capture.addConsumer(snapshotQueue);
+    FrameConsumer *recording = record ? &capture.addConsumer(recordingQueue) : nullptr;
+
+    if (record && !recorder.open(argv[1])) {
+        std::cerr << "Error: Unable to record to " << argv[1] << "!" << std::endl;
+        return -1;
+    }
+
+    // space requests a snapshot, it is written on its own thread so imwrite cannot stall capture
+    std::atomic<bool> snapshotRequested(false);
+    std::atomic<bool> done(false);
+    std::thread snapshotWriter([&]() {
+        while (!done) {
+            FrameRef frame = snapshots.next();
+            if (frame && snapshotRequested.exchange(false)) {
+                std::string path = "../test_" + std::to_string(frame->seq) + ".jpg";
+                cv::imwrite(path, frame->image);
+                std::cout << "wrote image " << path << std::endl;
+            }
         }
+    });
+    // only hands the frames to the recorder, which encodes them on its workers
+    std::thread recordingFeeder;
+    if (record) {
+        recordingFeeder = std::thread([&]() {
+            while (!done) {
+                FrameRef frame = recording->next();
+                if (frame) {
+                    recorder.write(frame);
+                }
+            }
+        });
+    }
 
-        cv::imshow("Stereo Image", frame);
+    capture.start();
+
+    cv::Mat rectified;
+    double rectifyTime = 0.0;
+    uint64_t rectifyCount = 0;
+    uint64_t lastCount = 0;
+    std::chrono::steady_clock::time_point lastStatus = std::chrono::steady_clock::now();
+    while (capture.running()) {
+        FrameRef frame = display.next();
+        if (frame && rectify) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            rectifier.rectify(frame->image, rectified);
+            rectifyTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            rectifyCount++;
+            cv::imshow("Stereo Image", rectified);
+        } else if (frame) {
+            cv::imshow("Stereo Image", frame->image);
+        }
 
-        std::cout << "Image " << imageSeq++ << " received with size " << frame.cols << " x " << frame.rows << "." << std::endl;
+        // one status line per second instead of one per image
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - lastStatus >= std::chrono::seconds(1)) {
+            uint64_t count = capture.captured();
+            double rate = (count - lastCount) / std::chrono::duration<double>(now - lastStatus).count();
+            std::cout << "Image " << count << " received with size " << capture.width() << " x " << capture.height()
+                << ", " << rate << " fps, " << display.dropped() << " not displayed, " << capture.exhausted() << " dropped";
+            if (record) {
+                std::cout << ", " << recorder.written() << " recorded, " << recording->dropped() + recorder.dropped() << " not recorded";
+            }
+            if (rectifyCount > 0) {
+                std::cout << ", rectified in " << 1000.0 * rectifyTime / rectifyCount << " ms";
+                rectifyTime = 0.0;
+                rectifyCount = 0;
+            }
+            std::cout << "." << std::endl;
+            lastCount = count;
+            lastStatus = now;
+        }
 
         int key = cv::waitKey(1);
         // esc to quit
         if (key == 27) {
             break;
         }
-        if (key == 32){
-            std::cout<<"wrote image"<<std::endl;
-            cv::imwrite("../test.jpg", frame);
+        if (key == 32) {
+            snapshotRequested = true;
+        }
+        if (key == 'r' && rectifier.loaded()) {
+            rectify = !rectify;
         }
+    }
 
+    capture.stop();
+    done = true;
+    snapshotWriter.join();
+    if (recordingFeeder.joinable()) {
+        recordingFeeder.join();
     }
-    
+    recorder.close();
+    if (record) {
+        std::cout << "Recorded " << recorder.written() << " of " << capture.captured() << " frames, "
+            << recording->dropped() + recorder.dropped() << " dropped, " << recorder.failed() << " failed." << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,125 @@
+#include <opencv2/core.hpp>
+#include <opencv2/highgui.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include "capturePipeline.h"
+#include "disparityEngine.h"
+#include "settings.h"
+#include "stereoRectifier.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// points further away than this are dropped, stereo depth is meaningless there
+const float MAX_DEPTH = 10.0f;
+
+int processImage(const char *imagePath, const char *cloudPath)
+{
+    cv::Mat image = cv::imread(imagePath);
+    if (image.empty()) {
+        std::cerr << "Error: Unable to read " << imagePath << "!" << std::endl;
+        return -1;
+    }
+    StereoRectifier rectifier;
+    if (!rectifier.load(CALIBRATION_FILE_PATH, image.cols, image.rows)) {
+        return -1;
+    }
+    DisparityEngine engine;
+    engine.setProjection(rectifier.projectionLeft(), rectifier.projectionRight());
+
+    cv::Mat rectified, disparity;
+    std::vector<cv::Point3f> points;
+    rectifier.rectify(image, rectified);
+    engine.compute(rectified, disparity);
+    engine.reproject(disparity, points, MAX_DEPTH);
+    if (!writePointCloud(cloudPath, points)) {
+        std::cerr << "Error: Unable to write " << cloudPath << "!" << std::endl;
+        return -1;
+    }
+    std::cout << "wrote " << points.size() << " points to " << cloudPath << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // stereoDepth <stereo image> <point cloud file> converts a single side-by-side image
+    if (argc == 3) {
+        return processImage(argv[1], argv[2]);
+    }
+    if (argc != 1) {
+        std::cout << "Usage: stereoDepth [<stereo image> <point cloud file>]" << std::endl;
+        return -1;
+    }
+
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_CAMERA)) {
+        return -1;
+    }
+    CapturePipeline capture;
+    if (!capture.open(settings)) {
+        std::cerr << "Error: Unable to open camera!" << std::endl;
+        return -1;
+    }
+    StereoRectifier rectifier;
+    if (!rectifier.load(CALIBRATION_FILE_PATH, capture.width(), capture.height())) {
+        return -1;
+    }
+    DisparityEngine engine;
+    engine.setProjection(rectifier.projectionLeft(), rectifier.projectionRight());
+    // depth is slower than the camera, only the latest frame is processed
+    FrameConsumer &frames = capture.addConsumer(1);
+    capture.start();
+
+    cv::Mat rectified, disparity, view;
+    std::vector<cv::Point3f> points;
+    double rectifyTime = 0.0, matchTime = 0.0;
+    uint64_t count = 0;
+    std::chrono::steady_clock::time_point lastStatus = std::chrono::steady_clock::now();
+    while (capture.running()) {
+        FrameRef frame = frames.next();
+        int key = cv::waitKey(1);
+        // esc to quit
+        if (key == 27) {
+            break;
+        }
+        if (!frame) {
+            continue;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        rectifier.rectify(frame->image, rectified);
+        std::chrono::steady_clock::time_point rectifiedAt = std::chrono::steady_clock::now();
+        engine.compute(rectified, disparity);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        rectifyTime += std::chrono::duration<double>(rectifiedAt - start).count();
+        matchTime += std::chrono::duration<double>(now - rectifiedAt).count();
+        count++;
+
+        disparity.convertTo(view, CV_8U, 255.0 / (16.0 * engine.numDisparities()));
+        cv::imshow("Disparity", view);
+
+        // space writes the point cloud of the current frame
+        if (key == 32) {
+            std::string path = "../cloud_" + std::to_string(frame->seq) + ".txt";
+            engine.reproject(disparity, points, MAX_DEPTH);
+            if (writePointCloud(path, points)) {
+                std::cout << "wrote " << points.size() << " points to " << path << std::endl;
+            } else {
+                std::cerr << "Error: Unable to write " << path << "!" << std::endl;
+            }
+        }
+
+        if (now - lastStatus >= std::chrono::seconds(1)) {
+            double elapsed = std::chrono::duration<double>(now - lastStatus).count();
+            std::cout << count / elapsed << " fps, rectified in " << 1000.0 * rectifyTime / count << " ms, matched in "
+                << 1000.0 * matchTime / count << " ms, " << frames.dropped() << " frames skipped." << std::endl;
+            rectifyTime = matchTime = 0.0;
+            count = 0;
+            lastStatus = now;
+        }
+    }
+
+    capture.stop();
+    return 0;
+}
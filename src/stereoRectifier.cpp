@@ -0,0 +1,103 @@
+#include "stereoRectifier.h"
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <iostream>
+
+namespace {
+
+bool readMatrix(const cv::FileNode &node, const char *name, int rows, int cols, cv::Mat &out)
+{
+    cv::FileNode entry = node[name];
+    if (entry.empty()) {
+        std::cerr << "Error: Calibration is missing " << name << "!" << std::endl;
+        return false;
+    }
+    entry >> out;
+    if (out.rows * out.cols != rows * cols) {
+        std::cerr << "Error: Calibration " << name << " has the wrong size!" << std::endl;
+        return false;
+    }
+    out = out.reshape(1, rows);
+    out.convertTo(out, CV_64F);
+    return true;
+}
+
+// first two rows of a camera or projection matrix scale with the image
+void scaleMatrix(cv::Mat &m, double sx, double sy)
+{
+    for (int c = 0; c < m.cols; c++) {
+        m.at<double>(0, c) *= sx;
+        m.at<double>(1, c) *= sy;
+    }
+}
+
+}
+
+StereoRectifier::StereoRectifier(int bands)
+    : bands_(bands < 1 ? 1 : bands)
+{
+}
+
+bool StereoRectifier::load(const std::string &path, int width, int height)
+{
+    cv::FileStorage file(path, cv::FileStorage::READ);
+    if (!file.isOpened()) {
+        std::cerr << "Error: Unable to open calibration " << path << "!" << std::endl;
+        return false;
+    }
+    cv::FileNode stereo = file["stereo"];
+    if (stereo.empty()) {
+        std::cerr << "Error: " << path << " has no stereo calibration!" << std::endl;
+        return false;
+    }
+
+    cv::Mat size, K1, D1, R1, K2, D2, R2;
+    if (!readMatrix(stereo, "image_size", 2, 1, size)
+        || !readMatrix(stereo, "K1", 3, 3, K1) || !readMatrix(stereo, "D1", 1, 5, D1)
+        || !readMatrix(stereo, "R1", 3, 3, R1) || !readMatrix(stereo, "P1", 3, 4, P1_)
+        || !readMatrix(stereo, "K2", 3, 3, K2) || !readMatrix(stereo, "D2", 1, 5, D2)
+        || !readMatrix(stereo, "R2", 3, 3, R2) || !readMatrix(stereo, "P2", 3, 4, P2_)) {
+        return false;
+    }
+
+    halfSize_ = cv::Size(width / 2, height);
+    if (halfSize_.width <= 0 || halfSize_.height <= 0) {
+        std::cerr << "Error: Invalid stereo image size " << width << " x " << height << "!" << std::endl;
+        return false;
+    }
+    double sx = halfSize_.width / size.at<double>(0);
+    double sy = halfSize_.height / size.at<double>(1);
+    if (sx != 1.0 || sy != 1.0) {
+        scaleMatrix(K1, sx, sy);
+        scaleMatrix(K2, sx, sy);
+        scaleMatrix(P1_, sx, sy);
+        scaleMatrix(P2_, sx, sy);
+    }
+
+    cv::initUndistortRectifyMap(K1, D1, R1, P1_, halfSize_, CV_16SC2, leftMap1_, leftMap2_);
+    cv::initUndistortRectifyMap(K2, D2, R2, P2_, halfSize_, CV_16SC2, rightMap1_, rightMap2_);
+    return true;
+}
+
+void StereoRectifier::rectify(const cv::Mat &frame, cv::Mat &rectified) const
+{
+    rectified.create(halfSize_.height, 2 * halfSize_.width, frame.type());
+    cv::Mat source[2] = {left(frame), right(frame)};
+    cv::Mat target[2] = {left(rectified), right(rectified)};
+    const cv::Mat *map1[2] = {&leftMap1_, &rightMap1_};
+    const cv::Mat *map2[2] = {&leftMap2_, &rightMap2_};
+    int rows = halfSize_.height;
+    int bands = bands_;
+
+    // every task remaps one row band of one half, remap only reads the source
+    cv::parallel_for_(cv::Range(0, 2 * bands), [&](const cv::Range &range) {
+        for (int task = range.start; task < range.end; task++) {
+            int side = task / bands;
+            int band = task % bands;
+            cv::Range bandRows(rows * band / bands, rows * (band + 1) / bands);
+            cv::Mat out = target[side].rowRange(bandRows);
+            cv::remap(source[side], out, map1[side]->rowRange(bandRows), map2[side]->rowRange(bandRows),
+                cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+        }
+    });
+}
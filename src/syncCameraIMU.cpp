@@ -0,0 +1,142 @@
+#include "capturePipeline.h"
+#include "commandChannel.h"
+#include "frameSync.h"
+#include "messageDecoder.h"
+#include "outputSink.h"
+#include "queuedSerialReader.h"
+#include "settings.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <thread>
+#include <csignal>
+
+
+sig_atomic_t volatile running = true;
+void sigHandler(int signum)
+{
+    if (signum == SIGINT) {
+        running = false;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    signal(SIGINT, &sigHandler);
+
+    Settings settings;
+    if (!loadSettings(settings, SETTINGS_SERIAL | SETTINGS_CAMERA)) {
+        return -1;
+    }
+
+    // the pool covers the consumer queue, the frames waiting for IMU data, the frame of the
+    // current pair, the frame being grabbed and one spare, so a lagging IMU never starves the grabber
+    const std::size_t frameQueue = 8, maxPending = 16;
+    CapturePipeline capture(frameQueue + maxPending + 1 + 1 + 1);
+    if (!capture.open(settings)) {
+        std::cerr << "Error: Unable to open camera!" << std::endl;
+        return -1;
+    }
+    FrameConsumer &frames = capture.addConsumer(frameQueue);
+
+    std::cout << "Opening port " << settings.serialPort.port << " with baudrate " << settings.serialPort.baudrate << "." << std::endl;
+    QueuedSerialReader reader;
+    reader.addPort(settings.serialPort.port, settings.serialPort.baudrate);
+    CommandChannel commands([&reader](const std::string &command) { reader.write(0, command); });
+    commands.subscribe("imu_raw");
+    commands.flush();
+
+    // the IMU is read on this thread, frames are paired on their own thread
+    FrameImuSync sync;
+    std::atomic<bool> done(false);
+    uint64_t paired = 0, failed = 0, expired = 0;
+    std::thread pairing([&]() {
+        OutputSink sink;
+        sink.openStdout();
+        std::ostream out(&sink);
+        out << std::setiosflags(std::ios_base::fixed) << std::setprecision(6);
+
+        std::deque<FrameRef> pending;
+        FrameImuPair result;
+        while (!done) {
+            sink.tick();
+            FrameRef frame = frames.next(10);
+            if (frame) {
+                // without IMU data for a while the oldest waiting frame is given up
+                if (pending.size() == maxPending) {
+                    pending.pop_front();
+                    expired++;
+                }
+                pending.push_back(frame);
+                frame.reset();
+            }
+            while (!pending.empty()) {
+                FrameImuSync::Result r = sync.pair(pending.front(), result);
+                if (r == FrameImuSync::Pending) {
+                    // give up on frames the IMU stream does not catch up with
+                    double now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+                    if (now - pending.front()->stamp < 1.0) {
+                        break;
+                    }
+                    expired++;
+                } else if (r == FrameImuSync::Failed) {
+                    failed++;
+                } else {
+                    paired++;
+                    out << "{\"msg\": \"frame_imu\", \"seq\": " << result.frame->seq << ", \"stamp\": " << result.stamp
+                        << ", \"clock_offset\": " << sync.clock().offset() << ", \"imu_samples\": " << result.samples.size()
+                        << ", \"ax\": " << result.imu.ax << ", \"ay\": " << result.imu.ay << ", \"az\": " << result.imu.az
+                        << ", \"wx\": " << result.imu.wx << ", \"wy\": " << result.imu.wy << ", \"wz\": " << result.imu.wz << "}\n";
+                    result.frame.reset();
+                }
+                pending.pop_front();
+            }
+        }
+        sink.flush();
+    });
+
+    reader.start();
+    capture.start();
+
+    Message msg;
+    unsigned long undecoded = 0;
+    while (running && capture.running()) {
+        commands.tick();
+        const FramedLine *line = reader.next();
+        if (line == nullptr) {
+            if (reader.closed()) {
+                break;
+            }
+            continue;
+        }
+        MessageType type;
+        try {
+            type = decodeMessage(line->begin(), line->end(), msg);
+        } catch (...) {
+            undecoded++;
+            reader.pop();
+            continue;
+        }
+        commands.received(msg.name);
+        if (type == MessageType::ImuRaw) {
+            sync.addImu(msg.imu, line->received);
+        }
+        reader.pop();
+    }
+
+    capture.stop();
+    reader.stop();
+    done = true;
+    pairing.join();
+
+    std::cerr << "Paired " << paired << " frames, " << failed << " outside the IMU data, " << expired << " without IMU data, "
+        << frames.dropped() << " skipped, " << capture.exhausted() << " dropped for lack of pooled frames." << std::endl;
+    if (undecoded > 0 || reader.truncated() > 0) {
+        std::cerr << "Warning: " << undecoded << " lines could not be decoded, " << reader.truncated() << " were too long!" << std::endl;
+    }
+
+    return 0;
+}